@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compares two json_parser_bench --json result files.
+
+Flags a phase as a regression when its time grows by more than the threshold,
+or when it makes more allocations per document than the baseline did.
+
+    compare_bench.py baseline.json current.json [--threshold 10] [--metric median_ms]
+
+Exits with status 1 if any phase regressed, so it can gate CI.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    rows = {(b["corpus"], b["phase"]): b for b in data["benchmarks"]}
+    return data.get("context", {}), rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--metric", choices=["median_ms", "best_ms"], default="median_ms",
+                        help="timing used for the comparison (default median_ms)")
+    args = parser.parse_args()
+
+    base_context, baseline = load(args.baseline)
+    current_context, current = load(args.current)
+    for key in ("optimized", "stage1", "corpus_megabytes"):
+        if base_context.get(key) != current_context.get(key):
+            print(f"warning: {key} differs: {base_context.get(key)} vs {current_context.get(key)}")
+
+    regressions = 0
+    print(f"{'corpus':<8} {'phase':<12} {'base ms':>9} {'new ms':>9} {'change':>8} "
+          f"{'base allocs':>12} {'new allocs':>12}")
+    for key, new in current.items():
+        old = baseline.get(key)
+        if old is None:
+            print(f"{key[0]:<8} {key[1]:<12} {'':>9} {new[args.metric]:9.2f}      new")
+            continue
+
+        change = (new[args.metric] - old[args.metric]) / old[args.metric] * 100 if old[args.metric] else 0.0
+        problems = []
+        if change > args.threshold:
+            problems.append("slower")
+        if new["allocations"] > old["allocations"]:
+            problems.append("more allocations")
+        if problems:
+            regressions += 1
+
+        print(f"{key[0]:<8} {key[1]:<12} {old[args.metric]:9.2f} {new[args.metric]:9.2f} {change:+7.1f}% "
+              f"{old['allocations']:12d} {new['allocations']:12d}"
+              + (f"  REGRESSION ({', '.join(problems)})" if problems else ""))
+
+    for key in sorted(baseline.keys() - current.keys()):
+        print(f"{key[0]:<8} {key[1]:<12} missing from {args.current}")
+
+    if regressions:
+        print(f"\n{regressions} regression(s) above {args.threshold:g}%")
+        return 1
+    print("\nno regressions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,205 @@
+#ifndef JSON_CORPUS_HPP
+#define JSON_CORPUS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Deterministic benchmark corpora. Every generator is seeded with a constant, so
+// the same size always produces byte-identical input and results from different
+// builds can be compared.
+namespace json_bench {
+
+// splitmix64: small, fast and identical on every platform
+class Random {
+    public:
+        explicit Random(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, bound)
+        uint64_t below(uint64_t bound) { return next() % bound; }
+
+        // Uniform in [low, high)
+        double between(double low, double high) {
+            return low + (high - low) * (static_cast<double>(next() >> 11) / 9007199254740992.0);
+        }
+
+        bool chance(unsigned percent) { return below(100) < percent; }
+
+    private:
+        uint64_t state;
+};
+
+inline const char* pick(Random& random, const char* const* words, size_t count) {
+    return words[random.below(count)];
+}
+
+inline void appendWords(std::string& out, Random& random, size_t count) {
+    static const char* const words[] = {
+        "the", "json", "parser", "fast", "stream", "token", "value", "array", "object", "caf\xC3\xA9",
+        "\xE6\x9D\xB1\xE4\xBA\xAC", "na\xC3\xAFve", "release", "benchmark", "#perf", "@team", "http://t.co/x1",
+        "\xF0\x9F\x9A\x80", "numbers", "deadline"};
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) out += ' ';
+        out += pick(random, words, sizeof(words) / sizeof(words[0]));
+    }
+}
+
+inline void appendDouble(std::string& out, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+// One twitter-API-like status: wide user object, entity arrays, nulls, big ids
+inline void appendStatus(std::string& out, Random& random, uint64_t index) {
+    static const char* const languages[] = {"en", "ja", "es", "fr", "de"};
+    static const char* const colors[] = {"C0DEED", "1DA1F2", "F5F8FA", "333333", "FFFFFF"};
+    uint64_t id = 505874924095815681ULL + index * 7919;
+    uint64_t userId = 1186275104ULL + random.below(1000000000ULL);
+
+    out += "{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"";
+    out += pick(random, languages, 5);
+    out += "\"},\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",\"id\":";
+    out += std::to_string(id);
+    out += ",\"id_str\":\"" + std::to_string(id) + "\",\"text\":\"";
+    appendWords(out, random, 8 + random.below(12));
+    if (random.chance(30)) out += " \\\"quoted\\\"\\nsecond line";
+    out += "\",\"source\":\"<a href=\\\"https://mobile.example.com\\\" rel=\\\"nofollow\\\">Mobile Web</a>\"";
+    out += ",\"truncated\":false,\"in_reply_to_status_id\":null,\"in_reply_to_user_id\":null";
+    out += ",\"user\":{\"id\":" + std::to_string(userId) + ",\"id_str\":\"" + std::to_string(userId) + "\"";
+    out += ",\"name\":\"";
+    appendWords(out, random, 2);
+    out += "\",\"screen_name\":\"user_" + std::to_string(random.below(100000)) + "\",\"location\":\"";
+    appendWords(out, random, 1 + random.below(3));
+    out += "\",\"description\":\"";
+    appendWords(out, random, 5 + random.below(15));
+    out += "\",\"url\":null,\"protected\":false,\"followers_count\":" + std::to_string(random.below(100000));
+    out += ",\"friends_count\":" + std::to_string(random.below(5000));
+    out += ",\"listed_count\":" + std::to_string(random.below(100));
+    out += ",\"favourites_count\":" + std::to_string(random.below(20000));
+    out += ",\"utc_offset\":" + (random.chance(50) ? std::string("null") : std::to_string(3600 * (int(random.below(24)) - 12)));
+    out += ",\"geo_enabled\":" + std::string(random.chance(40) ? "true" : "false");
+    out += ",\"verified\":" + std::string(random.chance(5) ? "true" : "false");
+    out += ",\"statuses_count\":" + std::to_string(random.below(50000));
+    out += ",\"lang\":\"" + std::string(pick(random, languages, 5)) + "\"";
+    out += ",\"profile_background_color\":\"" + std::string(pick(random, colors, 5)) + "\"";
+    out += ",\"profile_image_url_https\":\"https://pbs.example.com/profile_images/" +
+           std::to_string(random.below(1000000)) + "/avatar_normal.jpeg\"";
+    out += ",\"default_profile\":true,\"following\":false,\"notifications\":false}";
+    out += ",\"geo\":null,\"coordinates\":null,\"place\":null,\"contributors\":null";
+    out += ",\"retweet_count\":" + std::to_string(random.below(1000));
+    out += ",\"favorite_count\":" + std::to_string(random.below(1000));
+    out += ",\"entities\":{\"hashtags\":[";
+    for (uint64_t i = 0, count = random.below(3); i < count; i++) {
+        if (i > 0) out += ',';
+        out += "{\"text\":\"tag" + std::to_string(random.below(100)) + "\",\"indices\":[" +
+               std::to_string(i * 10) + "," + std::to_string(i * 10 + 6) + "]}";
+    }
+    out += "],\"symbols\":[],\"urls\":[],\"user_mentions\":[";
+    for (uint64_t i = 0, count = random.below(3); i < count; i++) {
+        if (i > 0) out += ',';
+        out += "{\"screen_name\":\"friend_" + std::to_string(random.below(1000)) + "\",\"id\":" +
+               std::to_string(random.below(3000000000ULL)) + ",\"indices\":[0,12]}";
+    }
+    out += "]},\"favorited\":false,\"retweeted\":false,\"lang\":\"" + std::string(pick(random, languages, 5)) + "\"}";
+}
+
+// {"statuses": [...], "search_metadata": {...}} in the style of twitter.json
+inline std::string makeTwitter(size_t targetBytes) {
+    Random random(1);
+    std::string out = "{\"statuses\":[";
+    for (uint64_t i = 0; out.size() < targetBytes; i++) {
+        if (i > 0) out += ',';
+        appendStatus(out, random, i);
+    }
+    out += "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"count\":100}}";
+    return out;
+}
+
+// A GeoJSON feature collection of polygons with 15-digit coordinates, like canada.json
+inline std::string makeCanada(size_t targetBytes) {
+    Random random(2);
+    std::string out = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+                      "\"properties\":{\"name\":\"Canada\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+    for (size_t ring = 0; out.size() < targetBytes; ring++) {
+        if (ring > 0) out += ',';
+        out += '[';
+        double lon = random.between(-141.0, -52.0);
+        double lat = random.between(41.0, 83.0);
+        for (int point = 0; point < 256; point++) {
+            if (point > 0) out += ',';
+            lon += random.between(-0.01, 0.01);
+            lat += random.between(-0.01, 0.01);
+            out += '[';
+            appendDouble(out, lon);
+            out += ',';
+            appendDouble(out, lat);
+            out += ']';
+        }
+        out += ']';
+    }
+    out += "]}}]}";
+    return out;
+}
+
+// An array of subtrees that alternate objects and arrays hundreds of levels deep
+inline std::string makeDeep(size_t targetBytes) {
+    Random random(3);
+    std::string out = "[";
+    for (size_t tree = 0; out.size() < targetBytes; tree++) {
+        if (tree > 0) out += ',';
+        size_t depth = 64 + random.below(448);
+        for (size_t level = 0; level < depth; level++) {
+            out += level % 2 ? "[" : "{\"k\":";
+        }
+        out += std::to_string(random.below(1000));
+        for (size_t level = depth; level-- > 0;) {
+            out += level % 2 ? ",true]" : ",\"n\":null}";
+        }
+    }
+    out += "]";
+    return out;
+}
+
+// Long strings where a large share of the bytes are escape sequences
+inline std::string makeStrings(size_t targetBytes) {
+    static const char* const escapes[] = {"\\n", "\\t", "\\\"", "\\\\", "\\/", "\\r", "\\b", "\\f"};
+    Random random(4);
+    std::string out = "[";
+    for (size_t i = 0; out.size() < targetBytes; i++) {
+        if (i > 0) out += ',';
+        out += '"';
+        for (uint64_t piece = 0, count = 4 + random.below(40); piece < count; piece++) {
+            if (random.chance(40)) {
+                out += pick(random, escapes, sizeof(escapes) / sizeof(escapes[0]));
+            } else {
+                appendWords(out, random, 1);
+            }
+        }
+        out += '"';
+    }
+    out += "]";
+    return out;
+}
+
+// Newline-delimited statuses
+inline std::string makeNDJSON(size_t targetBytes) {
+    Random random(5);
+    std::string out;
+    for (uint64_t i = 0; out.size() < targetBytes; i++) {
+        appendStatus(out, random, i);
+        out += '\n';
+    }
+    return out;
+}
+
+} // namespace json_bench
+
+#endif
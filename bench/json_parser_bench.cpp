@@ -0,0 +1,541 @@
+#include "json_bind.hpp"
+#include "json_corpus.hpp"
+#include "json_lazy.hpp"
+#include "json_ndjson.hpp"
+#include "json_parser.hpp"
+#include "json_query.hpp"
+#include "json_stage1.hpp"
+#include "json_stream.hpp"
+#include "json_tape.hpp"
+#include "json_writer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+// Every allocation made through global operator new is counted, so each phase
+// can report how many allocations one document costs
+namespace {
+std::atomic<size_t> allocationCount{0};
+std::atomic<size_t> allocatedBytes{0};
+
+void* countedAllocate(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource goes through the aligned overloads
+void* countedAllocateAligned(size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align, size ? size : 1) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void freeAligned(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+} // namespace
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+
+namespace {
+
+struct Options {
+    double megabytes = 4;
+    int iterations = 5;
+    std::string jsonPath;
+    std::vector<std::string> corpora;  // Empty runs all
+    std::vector<std::string> phases;   // Empty runs all
+};
+
+struct Result {
+    std::string corpus;
+    std::string phase;
+    size_t bytes = 0;
+    double bestMs = 0;
+    double medianMs = 0;
+    size_t allocations = 0;     // Per document, measured on the last iteration
+    size_t allocatedBytes = 0;
+    double peakRSSDelta = 0;    // Bytes above the RSS at the start of the phase
+    size_t retainedBytes = 0;   // Memory the phase's result holds on to, where it keeps one
+};
+
+// Resident set size in bytes, current or peak (high-water mark); 0 where unsupported
+size_t readStatus(const char* field) {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t length = std::strlen(field);
+    while (std::getline(status, line)) {
+        if (line.compare(0, length, field) == 0) return std::strtoull(line.c_str() + length, nullptr, 10) * 1024;
+    }
+#else
+    (void)field;
+#endif
+    return 0;
+}
+
+size_t currentRSS() { return readStatus("VmRSS:"); }
+
+// Lowers the high-water mark to the current RSS (Linux 4.0+), so the next
+// reading is the peak of one phase rather than of the whole process
+bool resetPeakRSS() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    return static_cast<bool>(clearRefs);
+#else
+    return false;
+#endif
+}
+
+size_t peakRSS() {
+    size_t peak = readStatus("VmHWM:");
+#ifdef __linux__
+    if (peak == 0) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        peak = static_cast<size_t>(usage.ru_maxrss) * 1024;
+    }
+#endif
+    return peak;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Keeps results observable so the optimizer cannot drop the work being timed
+volatile size_t sink = 0;
+
+bool selected(const std::vector<std::string>& filter, const std::string& name) {
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+// Counts SAX events without storing them
+class CountingHandler : public JSONHandler {
+    public:
+        size_t events = 0;
+
+        void onStartObject() override { events++; }
+        void onKey(std::string_view) override { events++; }
+        void onStartArray() override { events++; }
+        void onString(std::string_view) override { events++; }
+        void onNumber(double) override { events++; }
+        void onInt64(int64_t) override { events++; }
+        void onUint64(uint64_t) override { events++; }
+        void onBool(bool) override { events++; }
+        void onNull() override { events++; }
+};
+
+// Visits every node of a DOM tree and folds numbers and string lengths into a checksum
+double walkValue(const JSONValue& value) {
+    if (value.isObject()) {
+        double sum = 0;
+        for (const auto& member : value.asObject()) sum += member.first.size() + walkValue(member.second);
+        return sum;
+    }
+    if (value.isArray()) {
+        double sum = 0;
+        for (const JSONValue& element : value.asArray()) sum += walkValue(element);
+        return sum;
+    }
+    if (value.isNumber()) return value.asNumber();
+    if (value.isString()) return static_cast<double>(value.asString().size());
+    return value.isBool() && value.asBool() ? 1 : 0;
+}
+
+// The same fold over a tape
+double walkTape(JSONTapeValue value) {
+    double sum = 0;
+    if (value.isObject()) {
+        value.forEachField([&](std::string_view key, JSONTapeValue member) { sum += key.size() + walkTape(member); });
+        return sum;
+    }
+    if (value.isArray()) {
+        value.forEachElement([&](JSONTapeValue element) { sum += walkTape(element); });
+        return sum;
+    }
+    if (value.isNumber()) return value.asNumber();
+    if (value.isString()) return static_cast<double>(value.asString().size());
+    return value.isBool() && value.asBool() ? 1 : 0;
+}
+
+// The slice of a twitter status an application would bind; everything else is skipped
+struct TwitterUser {
+    uint64_t id = 0;
+    std::string screen_name;
+    int64_t followers_count = 0;
+    bool verified = false;
+};
+JSON_BIND(TwitterUser, id, screen_name, followers_count, verified)
+
+struct TwitterStatus {
+    uint64_t id = 0;
+    std::string text;
+    TwitterUser user;
+    int64_t retweet_count = 0;
+    std::string lang;
+};
+JSON_BIND(TwitterStatus, id, text, user, retweet_count, lang)
+
+struct TwitterTimeline {
+    std::vector<TwitterStatus> statuses;
+};
+JSON_BIND(TwitterTimeline, statuses)
+
+class Runner {
+    public:
+        explicit Runner(const Options& options) : options(options) {}
+
+        std::vector<Result> results;
+        size_t processPeak = 0;  // Highest RSS seen, since resetting the high-water mark loses it
+
+        // Runs one warm-up and then the timed iterations of a phase. retained, when
+        // given, reports the memory the phase's result keeps after the last run.
+        void measure(const std::string& corpus, const std::string& phase, size_t bytes,
+                     const std::function<size_t()>& run, const std::function<size_t()>& retained = nullptr) {
+            if (!selected(options.phases, phase)) return;
+            sink = sink + run();
+
+            Result result;
+            result.corpus = corpus;
+            result.phase = phase;
+            result.bytes = bytes;
+            std::vector<double> times;
+            times.reserve(static_cast<size_t>(options.iterations));  // Keeps its growth out of the counts
+            for (int i = 0; i < options.iterations; i++) {
+                size_t rssBefore = currentRSS();
+                processPeak = std::max(processPeak, peakRSS());
+                resetPeakRSS();
+                size_t allocationsBefore = allocationCount.load();
+                size_t bytesBefore = allocatedBytes.load();
+
+                auto start = std::chrono::steady_clock::now();
+                sink = sink + run();
+                times.push_back(elapsedMs(start));
+
+                result.allocations = allocationCount.load() - allocationsBefore;
+                result.allocatedBytes = allocatedBytes.load() - bytesBefore;
+                size_t peak = peakRSS();
+                processPeak = std::max(processPeak, peak);
+                double delta = static_cast<double>(peak) - static_cast<double>(rssBefore);
+                result.peakRSSDelta = std::max(result.peakRSSDelta, delta);
+            }
+            std::sort(times.begin(), times.end());
+            result.bestMs = times.front();
+            result.medianMs = times[times.size() / 2];
+            if (retained) result.retainedBytes = retained();
+
+            std::printf("%-8s %-12s %8.2f %9.2f %9.2f %9.1f %11zu %11.1f %9.1f %9.1f\n", corpus.c_str(),
+                        phase.c_str(), bytes / 1e6, result.bestMs, result.medianMs,
+                        bytes / 1e6 / (result.medianMs / 1e3), result.allocations, result.allocatedBytes / 1e6,
+                        result.peakRSSDelta / 1e6, result.retainedBytes / 1e6);
+            std::fflush(stdout);
+            results.push_back(result);
+        }
+
+        // Every single-document phase, from stage 1 alone up to serialization.
+        // Indented output of a deeply nested corpus is mostly indentation, so
+        // pretty printing can be left out.
+        void runDocument(const std::string& corpus, const std::string& text, bool pretty = true) {
+            std::string_view view(text);
+            size_t bytes = text.size();
+
+            std::vector<uint32_t> structurals;
+            measure(corpus, "stage1", bytes, [&] {
+                json_detail::findStructurals(text.data(), text.size(), structurals);
+                return structurals.size();
+            });
+            measure(corpus, "dom", bytes, [&] {
+                JSONValue root = JSONParser(view).parse();
+                return static_cast<size_t>(root.isObject());
+            });
+            JSONDocument document;
+            measure(corpus, "dom_arena", bytes, [&] {
+                JSONParser parser(view);
+                return static_cast<size_t>(document.parse(parser).isObject());
+            }, [&] { return document.memory().bytesUsed(); });
+            measure(corpus, "lazy", bytes, [&] {
+                JSONLazyDocument lazy(view);
+                return lazy.root().size();
+            });
+            JSONTape tape;
+            measure(corpus, "tape", bytes, [&] {
+                tape.parse(view);
+                return tape.wordCount();
+            }, [&] { return tape.memoryUsage(); });
+
+            // Full-tree traversal of the trees built above: pointer chasing against a linear scan
+            if (!document.empty()) {
+                measure(corpus, "walk_dom", bytes, [&] { return static_cast<size_t>(walkValue(document.root())); });
+            }
+            if (!tape.empty()) {
+                measure(corpus, "walk_tape", bytes, [&] { return static_cast<size_t>(walkTape(tape.root())); });
+            }
+            measure(corpus, "sax", bytes, [&] {
+                CountingHandler handler;
+                JSONStreamParser parser(handler);
+                parser.feed(view);
+                parser.finish();
+                return handler.events;
+            });
+
+            const JSONValue root = JSONParser(view).parse();
+            JSONWriter compact;
+            measure(corpus, "write", bytes, [&] { return compact.write(root).size(); });
+            if (pretty) {
+                JSONWriter indented(2);
+                measure(corpus, "write_pretty", bytes, [&] { return indented.write(root).size(); });
+            }
+        }
+
+        // Copying, view, buffer and mmap input: construction plus parse, and the
+        // RSS each adds for its copy of the input (none but "copy" should)
+        void runInputs(const std::string& corpus, const std::string& text) {
+            size_t bytes = text.size();
+            measure(corpus, "input_copy", bytes, [&] { return JSONParser(text).parse().asObject().size(); });
+            measure(corpus, "input_view", bytes, [&] {
+                return JSONParser(std::string_view(text)).parse().asObject().size();
+            });
+            measure(corpus, "input_buffer", bytes, [&] {
+                return JSONParser(text.data(), text.size()).parse().asObject().size();
+            });
+            if (!selected(options.phases, "input_mmap")) return;
+
+            const char* path = "json_parser_bench_input.json";
+            {
+                std::ofstream out(path, std::ios::binary);
+                out << text;
+                if (!out) throw std::runtime_error(std::string("Could not write ") + path);
+            }
+            measure(corpus, "input_mmap", bytes, [&] { return JSONParser::fromFile(path).parse().asObject().size(); });
+            std::remove(path);
+        }
+
+        // Reads a few fields per status: the access pattern the lazy document and queries are for
+        void runSparse(const std::string& corpus, const std::string& text) {
+            measure(corpus, "sparse_dom", text.size(), [&] {
+                JSONValue root = JSONParser(std::string_view(text)).parse();
+                size_t checksum = 0;
+                for (const JSONValue& status : root["statuses"].asArray()) {
+                    checksum += status["id"].asUint64() + status["user"]["screen_name"].asString().size();
+                }
+                return checksum;
+            });
+            measure(corpus, "sparse_lazy", text.size(), [&] {
+                JSONLazyDocument lazy{std::string_view(text)};
+                size_t checksum = 0;
+                lazy.root()["statuses"].forEachElement([&](JSONLazyValue status) {
+                    checksum += status["id"].asUint64() + status["user"]["screen_name"].asString().size();
+                });
+                return checksum;
+            });
+            measure(corpus, "bind", text.size(), [&] {
+                TwitterTimeline timeline = JSONBinder::read<TwitterTimeline>(text);
+                size_t checksum = 0;
+                for (const TwitterStatus& status : timeline.statuses) {
+                    checksum += status.id + status.user.screen_name.size();
+                }
+                return checksum;
+            });
+
+            // The same extraction as a compiled path, over the DOM and over the raw text
+            JSONQuery names = JSONQuery::path("$.statuses[*].user.screen_name");
+            const JSONValue root = JSONParser(std::string_view(text)).parse();
+            measure(corpus, "query_dom", text.size(), [&] {
+                size_t checksum = 0;
+                names.forEach(root, [&](const JSONValue& name) { checksum += name.asString().size(); });
+                return checksum;
+            });
+            measure(corpus, "query_lazy", text.size(), [&] {
+                JSONLazyDocument lazy{std::string_view(text)};
+                size_t checksum = 0;
+                names.forEach(lazy.root(), [&](JSONLazyValue name) { checksum += name.asString().size(); });
+                return checksum;
+            });
+        }
+
+        // The batch parser on one thread and on every core
+        void runNDJSON(const std::string& corpus, const std::string& text) {
+            std::vector<size_t> threadCounts{1};
+            size_t cores = std::max(1u, std::thread::hardware_concurrency());
+            if (cores > 1) threadCounts.push_back(cores);
+            for (size_t threads : threadCounts) {
+                NDJSONBatchParser batch(threads);
+                measure(corpus, "ndjson_" + std::to_string(threads), text.size(), [&] {
+                    size_t records = 0;
+                    batch.parse(text, [&](NDJSONRecord& record) { records += record.ok(); });
+                    return records;
+                });
+            }
+
+            // The same records one at a time through a long-lived document, as a
+            // request handler would parse them
+            std::vector<std::string_view> lines;
+            for (size_t start = 0, end; start < text.size(); start = end + 1) {
+                end = text.find('\n', start);
+                if (end == std::string::npos) end = text.size();
+                if (end > start) lines.push_back(std::string_view(text).substr(start, end - start));
+            }
+            JSONDocument document;
+            measure(corpus, "doc_reuse", text.size(), [&] {
+                size_t records = 0;
+                document.parseMany(lines, [&](size_t, const JSONValue& root) { records += root.isObject(); });
+                return records;
+            });
+        }
+
+    private:
+        const Options& options;
+};
+
+void usage(const char* program) {
+    std::cerr << "usage: " << program << " [options]\n"
+              << "  --size MB          bytes per corpus in megabytes (default 4)\n"
+              << "  --iterations N     timed runs per phase after one warm-up (default 5)\n"
+              << "  --corpus NAME      run only this corpus; may be repeated\n"
+              << "                     (twitter, canada, deep, strings, ndjson)\n"
+              << "  --phase NAME       run only this phase; may be repeated\n"
+              << "  --json PATH        also write the results as JSON to PATH\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--size" && hasValue) options.megabytes = std::strtod(argv[++i], nullptr);
+        else if (arg == "--iterations" && hasValue) options.iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--corpus" && hasValue) options.corpora.push_back(argv[++i]);
+        else if (arg == "--phase" && hasValue) options.phases.push_back(argv[++i]);
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else return false;
+    }
+    return options.megabytes > 0;
+}
+
+bool optimizedBuild() {
+#if defined(__OPTIMIZE__) || defined(NDEBUG)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Machine-readable results for bench/compare_bench.py
+void writeJSON(const Options& options, const std::vector<Result>& results, size_t processPeak) {
+    JSONWriter writer(2);
+    writer.beginObject();
+    writer.writeKey("context").beginObject();
+    writer.writeKey("stage1").writeString(json_detail::stage1Implementation());
+    writer.writeKey("optimized").writeBool(optimizedBuild());
+    writer.writeKey("threads").writeUint64(std::max(1u, std::thread::hardware_concurrency()));
+    writer.writeKey("corpus_megabytes").writeDouble(options.megabytes);
+    writer.writeKey("iterations").writeInt64(options.iterations);
+    writer.writeKey("peak_rss_bytes").writeUint64(processPeak);
+    writer.endObject();
+    writer.writeKey("benchmarks").beginArray();
+    for (const Result& result : results) {
+        writer.beginObject();
+        writer.writeKey("corpus").writeString(result.corpus);
+        writer.writeKey("phase").writeString(result.phase);
+        writer.writeKey("bytes").writeUint64(result.bytes);
+        writer.writeKey("best_ms").writeDouble(result.bestMs);
+        writer.writeKey("median_ms").writeDouble(result.medianMs);
+        writer.writeKey("mb_per_s").writeDouble(result.bytes / 1e6 / (result.medianMs / 1e3));
+        writer.writeKey("allocations").writeUint64(result.allocations);
+        writer.writeKey("allocated_bytes").writeUint64(result.allocatedBytes);
+        writer.writeKey("peak_rss_delta_bytes").writeDouble(result.peakRSSDelta);
+        writer.writeKey("retained_bytes").writeUint64(result.retainedBytes);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+
+    std::ofstream out(options.jsonPath, std::ios::binary);
+    out << writer.str() << '\n';
+    if (!out) throw std::runtime_error("Could not write " + options.jsonPath);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!optimizedBuild()) {
+        std::cerr << "warning: benchmark built without optimization; configure with -DCMAKE_BUILD_TYPE=Release\n";
+    }
+
+    try {
+        size_t bytes = static_cast<size_t>(options.megabytes * 1e6);
+        Runner runner(options);
+        std::printf("stage 1 kernel: %s\n\n", json_detail::stage1Implementation());
+        std::printf("%-8s %-12s %8s %9s %9s %9s %11s %11s %9s %9s\n", "corpus", "phase", "MB", "best ms",
+                    "median ms", "MB/s", "allocs/doc", "alloc MB", "peak +MB", "kept MB");
+
+        if (selected(options.corpora, "twitter")) {
+            std::string text = json_bench::makeTwitter(bytes);
+            runner.runDocument("twitter", text);
+            runner.runInputs("twitter", text);
+            runner.runSparse("twitter", text);
+        }
+        if (selected(options.corpora, "canada")) runner.runDocument("canada", json_bench::makeCanada(bytes));
+        if (selected(options.corpora, "deep")) runner.runDocument("deep", json_bench::makeDeep(bytes), false);
+        if (selected(options.corpora, "strings")) runner.runDocument("strings", json_bench::makeStrings(bytes));
+        if (selected(options.corpora, "ndjson")) runner.runNDJSON("ndjson", json_bench::makeNDJSON(bytes));
+
+        size_t processPeak = std::max(runner.processPeak, peakRSS());
+        std::printf("\nprocess peak RSS: %.1f MB\n", processPeak / 1e6);
+        if (!options.jsonPath.empty()) writeJSON(options, runner.results, processPeak);
+    } catch (const std::exception& e) {
+        std::cerr << "benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,428 @@
+#ifndef JSON_BIND_HPP
+#define JSON_BIND_HPP
+#include "json_parser.hpp"
+#include "json_reader.hpp"
+#include "json_writer.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Reads JSON text straight into C++ structs, and writes them back, with no
+// JSONValue in between. Register a struct's public members once, at namespace
+// scope in the struct's own namespace:
+//
+//   struct User { std::string name; int64_t id = 0; std::vector<std::string> tags; };
+//   JSON_BIND(User, name, id, tags)
+//
+//   User user = JSONBinder::read<User>(text);
+//   std::string text = JSONBinder::write(user);
+//
+// The member names become the keys. Each bound struct gets a perfect hash over
+// its keys built at compile time, so matching a key costs one hash and one
+// compare. Unknown keys are validated and skipped; missing keys leave the member
+// as it was. Members may be bool, integers (range checked), floating point,
+// std::string, std::optional (omitted when empty), std::vector, std::map or
+// std::unordered_map keyed by std::string, JSONValue, or another bound struct.
+// Other types plug in by specializing json_detail::Binding<T>.
+namespace json_detail {
+
+template <typename Class, typename Member>
+struct BoundField {
+    using Type = Member;
+    std::string_view name;
+    Member Class::*member;
+};
+
+template <typename Class, typename Member>
+constexpr BoundField<Class, Member> boundField(std::string_view name, Member Class::*member) {
+    return {name, member};
+}
+
+// FNV-1a with the seed folded into the offset basis, then mixed so the low bits are usable
+constexpr uint64_t keyHash(std::string_view key, uint64_t seed) {
+    uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+    for (char ch : key) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ (hash >> 29) ^ (hash >> 47);
+}
+
+// At most one key in eight slots keeps a collision-free seed quick to find
+constexpr size_t keyTableSize(size_t keys) {
+    size_t size = 8;
+    while (size < keys * 8) size *= 2;
+    return size;
+}
+
+// Perfect hash over a fixed key set: every key lands in its own slot
+template <size_t N>
+struct KeyTable {
+    static constexpr size_t size = keyTableSize(N);
+
+    std::array<std::string_view, N> keys{};
+    uint64_t seed = 0;
+    std::array<uint8_t, size> slots{};  // Key index + 1, or 0 when empty
+
+    // Index of key, or N when it is not in the set
+    constexpr size_t find(std::string_view key) const {
+        size_t slot = slots[keyHash(key, seed) & (size - 1)];
+        return slot != 0 && keys[slot - 1] == key ? slot - 1 : N;
+    }
+};
+
+// Tries seeds until none of the keys collide. Evaluated at compile time, where
+// the throws turn into compile errors.
+template <size_t N>
+constexpr KeyTable<N> makeKeyTable(const std::array<std::string_view, N>& keys) {
+    static_assert(N < 256, "JSON_BIND supports up to 255 members");
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            if (keys[i] == keys[j]) throw std::logic_error("JSON_BIND: duplicate key");
+        }
+    }
+
+    for (uint64_t seed = 0; seed < 65536; seed++) {
+        KeyTable<N> table{};
+        table.keys = keys;
+        table.seed = seed;
+        bool collision = false;
+        for (size_t i = 0; i < N && !collision; i++) {
+            uint8_t& slot = table.slots[keyHash(keys[i], seed) & (KeyTable<N>::size - 1)];
+            if (slot != 0) collision = true;
+            else slot = static_cast<uint8_t>(i + 1);
+        }
+        if (!collision) return table;
+    }
+    throw std::logic_error("JSON_BIND: no perfect hash found for these keys");
+}
+
+template <typename Fields, size_t... I>
+constexpr std::array<std::string_view, sizeof...(I)> fieldNames(const Fields& fields, std::index_sequence<I...>) {
+    return {{std::get<I>(fields).name...}};
+}
+
+// A type is bound when JSON_BIND declared jsonBindFields for it (found by ADL)
+template <typename T, typename = void>
+struct IsBound : std::false_type {};
+
+template <typename T>
+struct IsBound<T, std::void_t<decltype(jsonBindFields(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+// Compile-time description of a bound struct: its members and the key table
+template <typename T>
+struct BoundStruct {
+    static constexpr auto fields = jsonBindFields(static_cast<const T*>(nullptr));
+    static constexpr size_t count = std::tuple_size<std::remove_const_t<decltype(fields)>>::value;
+    static constexpr KeyTable<count> table = makeKeyTable<count>(fieldNames(fields, std::make_index_sequence<count>()));
+};
+
+template <typename T>
+struct IsOptional : std::false_type {};
+
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+struct AlwaysFalse : std::false_type {};
+
+// How one C++ type is read from a JSONReader and written to a JSONWriter
+template <typename T, typename Enable = void>
+struct Binding {
+    static_assert(AlwaysFalse<T>::value, "No JSON binding for this type; register it with JSON_BIND");
+};
+
+template <typename T>
+struct Binding<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+    static void read(JSONReader& reader, T& out) {
+        if constexpr (std::is_same<T, bool>::value) {
+            out = reader.readBool();
+        } else if constexpr (std::is_floating_point<T>::value) {
+            out = static_cast<T>(reader.readDouble());
+        } else if constexpr (std::is_signed<T>::value) {
+            int64_t value = reader.readInt64();
+            if constexpr (sizeof(T) < sizeof(int64_t)) {
+                if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                    reader.fail("Number out of range for the target type");
+                }
+            }
+            out = static_cast<T>(value);
+        } else {
+            uint64_t value = reader.readUint64();
+            if constexpr (sizeof(T) < sizeof(uint64_t)) {
+                if (value > std::numeric_limits<T>::max()) reader.fail("Number out of range for the target type");
+            }
+            out = static_cast<T>(value);
+        }
+    }
+
+    static void write(JSONWriter& writer, T value) {
+        if constexpr (std::is_same<T, bool>::value) writer.writeBool(value);
+        else if constexpr (std::is_floating_point<T>::value) writer.writeDouble(static_cast<double>(value));
+        else if constexpr (std::is_signed<T>::value) writer.writeInt64(static_cast<int64_t>(value));
+        else writer.writeUint64(static_cast<uint64_t>(value));
+    }
+};
+
+template <>
+struct Binding<std::string> {
+    static void read(JSONReader& reader, std::string& out) {
+        std::string_view text = reader.readString();
+        out.assign(text.data(), text.size());
+    }
+
+    static void write(JSONWriter& writer, const std::string& value) { writer.writeString(value); }
+};
+
+template <>
+struct Binding<JSONValue> {
+    // The subtree is validated once by the reader, then parsed in place
+    static void read(JSONReader& reader, JSONValue& out) { out = JSONParser(reader.readRaw()).parse(); }
+
+    static void write(JSONWriter& writer, const JSONValue& value) { writer.writeValue(value); }
+};
+
+template <typename T>
+struct Binding<std::optional<T>> {
+    static void read(JSONReader& reader, std::optional<T>& out) {
+        if (reader.readNull()) {
+            out.reset();
+            return;
+        }
+        if (!out) out.emplace();
+        Binding<T>::read(reader, *out);
+    }
+
+    static void write(JSONWriter& writer, const std::optional<T>& value) {
+        if (value) Binding<T>::write(writer, *value);
+        else writer.writeNull();
+    }
+};
+
+template <typename T, typename Allocator>
+struct Binding<std::vector<T, Allocator>> {
+    static void read(JSONReader& reader, std::vector<T, Allocator>& out) {
+        out.clear();
+        reader.beginArray();
+        while (reader.nextElement()) {
+            T element{};
+            Binding<T>::read(reader, element);
+            out.push_back(std::move(element));
+        }
+    }
+
+    static void write(JSONWriter& writer, const std::vector<T, Allocator>& value) {
+        writer.beginArray();
+        for (const auto& element : value) Binding<T>::write(writer, element);
+        writer.endArray();
+    }
+};
+
+// Objects with arbitrary keys, for std::map and std::unordered_map
+template <typename Map>
+struct MapBinding {
+    using Mapped = typename Map::mapped_type;
+
+    static void read(JSONReader& reader, Map& out) {
+        out.clear();
+        reader.beginObject();
+        std::string_view key;
+        while (reader.nextKey(key)) {
+            Mapped& slot = out[std::string(key)];
+            Binding<Mapped>::read(reader, slot);
+        }
+    }
+
+    static void write(JSONWriter& writer, const Map& value) {
+        writer.beginObject();
+        for (const auto& entry : value) {
+            writer.writeKey(entry.first);
+            Binding<Mapped>::write(writer, entry.second);
+        }
+        writer.endObject();
+    }
+};
+
+template <typename T, typename Compare, typename Allocator>
+struct Binding<std::map<std::string, T, Compare, Allocator>>
+    : MapBinding<std::map<std::string, T, Compare, Allocator>> {};
+
+template <typename T, typename Hash, typename Equal, typename Allocator>
+struct Binding<std::unordered_map<std::string, T, Hash, Equal, Allocator>>
+    : MapBinding<std::unordered_map<std::string, T, Hash, Equal, Allocator>> {};
+
+// Structs registered with JSON_BIND: keys dispatch through the compile-time table
+template <typename T>
+struct Binding<T, std::enable_if_t<IsBound<T>::value>> {
+    using Description = BoundStruct<T>;
+
+    static void read(JSONReader& reader, T& out) {
+        reader.beginObject();
+        std::string_view key;
+        while (reader.nextKey(key)) {
+            size_t field = Description::table.find(key);
+            if (field == Description::count) reader.skipValue();
+            else readField(reader, out, field, std::make_index_sequence<Description::count>());
+        }
+    }
+
+    static void write(JSONWriter& writer, const T& value) {
+        writer.beginObject();
+        writeFields(writer, value, std::make_index_sequence<Description::count>());
+        writer.endObject();
+    }
+
+    private:
+        template <size_t I>
+        using MemberType = typename std::tuple_element<I, std::remove_const_t<decltype(Description::fields)>>::type::Type;
+
+        // Expands to a chain of index compares that the compiler turns into a jump table
+        template <size_t... I>
+        static void readField(JSONReader& reader, T& out, size_t field, std::index_sequence<I...>) {
+            (void)((field == I && (Binding<MemberType<I>>::read(reader, out.*(std::get<I>(Description::fields).member)), true)) || ...);
+        }
+
+        template <size_t... I>
+        static void writeFields(JSONWriter& writer, const T& value, std::index_sequence<I...>) {
+            (writeField<I>(writer, value), ...);
+        }
+
+        template <size_t I>
+        static void writeField(JSONWriter& writer, const T& value) {
+            const auto& member = value.*(std::get<I>(Description::fields).member);
+            if constexpr (IsOptional<MemberType<I>>::value) {
+                if (!member) return;
+            }
+            writer.writeKey(std::get<I>(Description::fields).name);
+            Binding<MemberType<I>>::write(writer, member);
+        }
+};
+
+} // namespace json_detail
+
+// Entry points for bound types
+class JSONBinder {
+    public:
+        template <typename T>
+        static T read(std::string_view json) {
+            T value{};
+            read(json, value);
+            return value;
+        }
+
+        // Reads into an existing object; members whose keys are absent keep their values
+        template <typename T>
+        static void read(std::string_view json, T& out) {
+            JSONReader reader(json);
+            json_detail::Binding<T>::read(reader, out);
+            reader.finish();
+        }
+
+        // indent == 0 writes compact JSON
+        template <typename T>
+        static std::string write(const T& value, int indent = 0) {
+            JSONWriter writer(indent);
+            json_detail::Binding<T>::write(writer, value);
+            return writer.str();
+        }
+
+        template <typename T>
+        static void write(JSONWriter& writer, const T& value) {
+            json_detail::Binding<T>::write(writer, value);
+        }
+};
+
+// JSON_BIND(Type, member...) registers up to 64 public members of Type
+#define JSON_BIND(Type, ...)                                                                \
+    constexpr auto jsonBindFields(const Type*) {                                            \
+        return std::make_tuple(JSON_BIND_EXPAND(JSON_BIND_MAP(JSON_BIND_FIELD, Type, __VA_ARGS__))); \
+    }
+
+#define JSON_BIND_FIELD(Type, member) ::json_detail::boundField(#member, &Type::member)
+
+// Preprocessor plumbing: applies m(Type, x) to each member name. JSON_BIND_EXPAND
+// forces the rescans MSVC's traditional preprocessor otherwise skips.
+#define JSON_BIND_EXPAND(x) x
+#define JSON_BIND_CONCAT(a, b) JSON_BIND_CONCAT_(a, b)
+#define JSON_BIND_CONCAT_(a, b) a##b
+#define JSON_BIND_MAP(m, T, ...) \
+    JSON_BIND_EXPAND(JSON_BIND_CONCAT(JSON_BIND_MAP_, JSON_BIND_COUNT(__VA_ARGS__))(m, T, __VA_ARGS__))
+#define JSON_BIND_COUNT(...) JSON_BIND_EXPAND(JSON_BIND_COUNT_(__VA_ARGS__, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define JSON_BIND_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, N, ...) N
+#define JSON_BIND_MAP_1(m, T, a) m(T, a)
+#define JSON_BIND_MAP_2(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_1(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_3(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_2(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_4(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_3(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_5(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_4(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_6(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_5(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_7(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_6(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_8(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_7(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_9(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_8(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_10(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_9(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_11(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_10(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_12(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_11(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_13(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_12(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_14(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_13(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_15(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_14(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_16(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_15(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_17(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_16(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_18(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_17(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_19(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_18(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_20(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_19(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_21(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_20(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_22(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_21(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_23(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_22(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_24(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_23(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_25(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_24(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_26(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_25(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_27(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_26(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_28(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_27(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_29(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_28(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_30(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_29(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_31(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_30(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_32(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_31(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_33(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_32(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_34(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_33(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_35(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_34(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_36(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_35(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_37(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_36(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_38(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_37(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_39(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_38(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_40(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_39(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_41(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_40(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_42(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_41(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_43(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_42(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_44(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_43(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_45(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_44(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_46(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_45(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_47(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_46(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_48(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_47(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_49(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_48(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_50(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_49(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_51(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_50(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_52(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_51(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_53(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_52(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_54(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_53(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_55(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_54(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_56(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_55(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_57(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_56(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_58(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_57(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_59(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_58(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_60(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_59(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_61(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_60(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_62(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_61(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_63(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_62(m, T, __VA_ARGS__))
+#define JSON_BIND_MAP_64(m, T, a, ...) m(T, a), JSON_BIND_EXPAND(JSON_BIND_MAP_63(m, T, __VA_ARGS__))
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef JSON_LAZY_HPP
+#define JSON_LAZY_HPP
+#include "json_parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class JSONLazyDocument;
+
+namespace json_detail {
+struct ParsedNumber;
+}
+
+// Handle to one value inside a JSONLazyDocument. Copying a handle is free; nothing
+// is decoded until an accessor asks for it. A handle is only valid while its
+// document is alive.
+class JSONLazyValue {
+    public:
+        JSONLazyValue() = default;
+
+        // False for the handle returned when an object key is missing
+        bool exists() const { return document != nullptr; }
+
+        // Type checks only look at the value's first byte; malformed scalars are
+        // reported by the as*() accessors. A missing key reads as null.
+        bool isNull() const;
+        bool isBool() const;
+        bool isNumber() const;
+        bool isInteger() const;
+        bool isString() const;
+        bool isArray() const;
+        bool isObject() const;
+
+        bool asBool() const;
+        double asNumber() const;
+        int64_t asInt64() const;
+        uint64_t asUint64() const;
+        std::string asString() const;
+
+        // Field lookup scans the object's keys and skips every other value in O(1).
+        // A repeated key reads as its last value, as JSONValue keeps it. Returns a
+        // handle whose exists() is false when the key is absent.
+        JSONLazyValue operator[](std::string_view key) const;
+
+        // Walks the array up to index, skipping the elements before it
+        JSONLazyValue operator[](size_t index) const;
+
+        // Number of array elements or distinct object keys
+        size_t size() const;
+
+        // Visits every element or member in order without decoding the values. A
+        // repeated key is visited once, at its first position, with its last value.
+        void forEachElement(const std::function<void(JSONLazyValue)>& visit) const;
+        void forEachField(const std::function<void(const std::string& key, JSONLazyValue value)>& visit) const;
+
+        // The value's source text, from its first byte to the end of its last token
+        std::string_view rawJSON() const;
+
+        // Fully parses this value (and its subtree) into a JSONValue
+        JSONValue materialize() const;
+
+    private:
+        friend class JSONLazyDocument;
+
+        const JSONLazyDocument* document = nullptr;
+        uint32_t token = 0;  // Index into the document's structural list
+
+        JSONLazyValue(const JSONLazyDocument* document, uint32_t token) : document(document), token(token) {}
+
+        char firstChar() const;
+        void parseNumber(json_detail::ParsedNumber& number) const;
+        void distinctMembers(std::vector<std::pair<std::string, uint32_t>>& members) const;
+        void checkLiteral(std::string_view literal) const;
+        void requireKind(char open, const char* message) const;
+};
+
+// On-demand document. Construction runs stage 1 and one pass over the token list
+// that checks the bracket structure and records where every object and array
+// ends. Strings, numbers and literals are only decoded, and only validated, when
+// an accessor reaches them, and unvisited subtrees are skipped in O(1).
+class JSONLazyDocument {
+    public:
+        // Copies the input; the document owns its own buffer
+        explicit JSONLazyDocument(const std::string& jsonString);
+        explicit JSONLazyDocument(std::string&& jsonString);
+        explicit JSONLazyDocument(const char* jsonString);
+
+        // Zero-copy: the caller's buffer must outlive the document
+        explicit JSONLazyDocument(std::string_view jsonView);
+        JSONLazyDocument(const char* data, size_t length);
+
+        // Maps the file read-only and indexes it in place
+        static JSONLazyDocument fromFile(const std::string& path);
+
+        // Handles point back into the document, so it cannot be copied or moved
+        JSONLazyDocument(const JSONLazyDocument&) = delete;
+        JSONLazyDocument& operator=(const JSONLazyDocument&) = delete;
+
+        JSONLazyValue root() const { return JSONLazyValue(this, 0); }
+
+    private:
+        friend class JSONLazyValue;
+
+        std::shared_ptr<const void> storage;  // Keeps copied or mapped input alive
+        std::string_view json;
+        std::vector<uint32_t> structurals;  // Token offsets found by stage 1
+        std::vector<uint32_t> closers;      // For '{' and '[' tokens, the index of the matching close
+
+        JSONLazyDocument(std::shared_ptr<const void> storage, std::string_view json);
+
+        void buildIndex();
+        uint32_t skip(uint32_t token) const;
+        size_t tokenOffset(uint32_t token) const { return structurals[token]; }
+        size_t tokenEnd(uint32_t token) const;
+};
+
+#endif
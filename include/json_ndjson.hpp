@@ -0,0 +1,61 @@
+#ifndef JSON_NDJSON_HPP
+#define JSON_NDJSON_HPP
+#include "json_parser.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json_detail {
+class WorkStealingPool;
+}
+
+// One line of newline-delimited JSON
+struct NDJSONRecord {
+    JSONValue value;
+    std::string error;  // Parse error message; empty when the record is valid
+    size_t line = 0;    // 1-based line number in the input
+
+    bool ok() const { return error.empty(); }
+};
+
+// Parses NDJSON / JSON Lines input across a pool of worker threads.
+// The input is cut into chunks on newline boundaries and the chunks are spread
+// over the workers with work stealing. Records always come back in input order,
+// blank lines are skipped, and a malformed record only marks that record as failed.
+class NDJSONBatchParser {
+    public:
+        // threads == 0 uses std::thread::hardware_concurrency()
+        explicit NDJSONBatchParser(size_t threads = 0);
+        ~NDJSONBatchParser();
+
+        NDJSONBatchParser(const NDJSONBatchParser&) = delete;
+        NDJSONBatchParser& operator=(const NDJSONBatchParser&) = delete;
+
+        // Parses every record and returns them in input order
+        std::vector<NDJSONRecord> parse(std::string_view input);
+
+        // Hands each record to callback on the calling thread, in input order.
+        // Only a window of chunks is held in memory at a time.
+        void parse(std::string_view input, const std::function<void(NDJSONRecord&)>& callback);
+
+        // Memory-maps the file and parses it
+        std::vector<NDJSONRecord> parseFile(const std::string& path);
+        void parseFile(const std::string& path, const std::function<void(NDJSONRecord&)>& callback);
+
+        size_t threadCount() const;
+
+        // Target chunk size in bytes; smaller chunks balance better, larger ones cost less overhead
+        void setChunkBytes(size_t bytes) { chunkBytes = bytes > 0 ? bytes : 1; }
+
+    private:
+        std::unique_ptr<json_detail::WorkStealingPool> pool;
+        size_t chunkBytes = 256 * 1024;
+
+        void parseChunks(std::string_view input, size_t windowChunks,
+                         const std::function<void(std::vector<NDJSONRecord>&)>& deliver);
+};
+
+#endif
@@ -1,16 +1,146 @@
 #ifndef JSON_PARSER_IMPL_HPP
 #define JSON_PARSER_IMPL_HPP
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <shared_mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <variant>
- 
+
+// Parse statistics are collected only when the library is built with
+// JSON_PARSER_STATS=1 (CMake option JSON_PARSER_STATS); otherwise the hooks
+// compile away and every counter stays zero.
+#ifndef JSON_PARSER_STATS
+#define JSON_PARSER_STATS 0
+#endif
+
+class JSONValue;
+
+// An object key. Keys of up to inlineCapacity bytes are stored in the key itself;
+// longer ones point at bytes owned by their object or shared through a JSONKeyTable.
+// A key copied out of an object is a view and lives only as long as the object.
+class JSONKey {
+    public:
+        static constexpr size_t inlineCapacity = 16;
+
+        JSONKey() {}
+
+        const char* data() const { return length <= inlineCapacity ? small : large; }
+        size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+        std::string_view view() const { return std::string_view(data(), length); }
+        operator std::string_view() const { return view(); }
+
+        // True when the bytes belong to a JSONKeyTable rather than to the object
+        bool isInterned() const { return interned; }
+
+        friend bool operator==(const JSONKey& a, const JSONKey& b) { return a.view() == b.view(); }
+        friend bool operator==(const JSONKey& a, std::string_view b) { return a.view() == b; }
+        friend bool operator==(std::string_view a, const JSONKey& b) { return a == b.view(); }
+        friend bool operator!=(const JSONKey& a, const JSONKey& b) { return !(a == b); }
+        friend bool operator!=(const JSONKey& a, std::string_view b) { return !(a == b); }
+        friend bool operator!=(std::string_view a, const JSONKey& b) { return !(a == b); }
+        friend std::ostream& operator<<(std::ostream& out, const JSONKey& key) { return out << key.view(); }
+
+    private:
+        union {
+            char small[inlineCapacity] = {};  // Zero-padded, so short keys compare as two words
+            const char* large;
+        };
+        uint32_t length = 0;
+        bool interned = false;
+
+        friend class JSONObject;
+        friend class JSONKeyTable;
+};
+
+// Members of a JSON object in insertion order, in one flat vector. Objects of up
+// to linearLimit members are searched linearly, comparing short keys a word at a
+// time; larger ones also keep an open-addressing index of member positions, so
+// lookups stay O(1) on wide objects. The interface follows std::unordered_map.
+class JSONObject {
+    public:
+        using key_type = JSONKey;
+        using mapped_type = JSONValue;
+        using value_type = std::pair<JSONKey, JSONValue>;
+        using iterator = value_type*;
+        using const_iterator = const value_type*;
+
+        static constexpr size_t linearLimit = 8;
+
+        JSONObject();
+        explicit JSONObject(std::pmr::memory_resource* resource);
+
+        // Copies go to the default resource, as pmr containers do, and own all their keys
+        JSONObject(const JSONObject& other);
+        JSONObject(JSONObject&& other) noexcept;
+        JSONObject& operator=(const JSONObject& other);
+        JSONObject& operator=(JSONObject&& other);
+        ~JSONObject();
+
+        size_t size() const;
+        bool empty() const;
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        iterator find(std::string_view key);
+        const_iterator find(std::string_view key) const;
+        size_t count(std::string_view key) const;
+        bool contains(std::string_view key) const;
+
+        // Throws std::out_of_range when key is absent
+        JSONValue& at(std::string_view key);
+        const JSONValue& at(std::string_view key) const;
+
+        // Inserts null when key is absent
+        JSONValue& operator[](std::string_view key);
+
+        // A later duplicate replaces the value but keeps the first position.
+        // Interned keys are shared; all others are copied into the object.
+        std::pair<iterator, bool> insert_or_assign(std::string_view key, JSONValue value);
+        std::pair<iterator, bool> insert_or_assign(const JSONKey& key, JSONValue value);
+
+        size_t erase(std::string_view key);
+        void clear();
+        void reserve(size_t count);
+
+        std::pmr::memory_resource* resource() const { return members.get_allocator().resource(); }
+
+        // Bytes held by the lookup index; 0 while the object is searched linearly
+        size_t indexBytes() const { return indexMask ? (static_cast<size_t>(indexMask) + 1) * sizeof(uint32_t) : 0; }
+
+    private:
+        std::pmr::vector<value_type> members;
+        uint32_t* index = nullptr;  // Member position + 1 per slot, 0 when empty
+        uint32_t indexMask = 0;     // Slot count - 1, or 0 while there is no index
+
+        size_t findPosition(std::string_view key) const;  // size() when absent
+        JSONKey copyKey(std::string_view key);
+        void freeKey(const JSONKey& key);
+        iterator append(JSONKey key, JSONValue&& value);
+        void copyFrom(const JSONObject& other);
+        void buildIndex(size_t slots);
+        void unindex(size_t position);
+        void releaseIndex();
+};
+
 class JSONValue {
     public:
-        using Object = std::unordered_map<std::string, JSONValue>;
-        using Array = std::vector<JSONValue>;
-        using ValueType = std::variant<std::nullptr_t, bool, double, std::string, Array, Object>;
+        // Containers allocate from a std::pmr::memory_resource, so a whole document
+        // can live in one JSONArena; default-constructed ones use the heap.
+        using String = std::pmr::string;
+        using Object = JSONObject;
+        using Array = std::pmr::vector<JSONValue>;
+        // Integers that fit are stored exactly as int64_t/uint64_t; every other number is a double
+        using ValueType = std::variant<std::nullptr_t, bool, double, int64_t, uint64_t, String, Array, Object>;
     
     private:
         ValueType value;
@@ -20,18 +150,37 @@ class JSONValue {
         JSONValue(std::nullptr_t) : value(nullptr) {}
         JSONValue(bool b) : value(b) {}
         JSONValue(double d) : value(d) {}
-        JSONValue(int i) : value(double(i)) {}
-        JSONValue(const std::string& s) : value(s) {}
-        JSONValue(const char* c) : value(std::string(c)) {}
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+        JSONValue(T i) {
+            if (std::is_signed<T>::value) value = static_cast<int64_t>(i);
+            else value = static_cast<uint64_t>(i);
+        }
+        JSONValue(const std::string& s) : value(String(s.data(), s.size())) {}
+        JSONValue(std::string_view s) : value(String(s)) {}
+        JSONValue(const char* c) : value(String(c)) {}
+        JSONValue(const String& s) : value(s) {}
+        JSONValue(String&& s) : value(std::move(s)) {}
         JSONValue(const Array& a) : value(a) {}
+        JSONValue(Array&& a) : value(std::move(a)) {}
         JSONValue(const Object& o) : value(o) {}
+        JSONValue(Object&& o) : value(std::move(o)) {}
     
         bool isNull() const { return std::holds_alternative<std::nullptr_t>(value); }
         bool isBool() const { return std::holds_alternative<bool>(value); }
-        bool isNumber() const { return std::holds_alternative<double>(value); }
-        bool isString() const { return std::holds_alternative<std::string>(value); }
+        bool isNumber() const {
+            return std::holds_alternative<double>(value) || std::holds_alternative<int64_t>(value) ||
+                   std::holds_alternative<uint64_t>(value);
+        }
+        bool isInteger() const {
+            return std::holds_alternative<int64_t>(value) || std::holds_alternative<uint64_t>(value);
+        }
+        bool isString() const { return std::holds_alternative<String>(value); }
         bool isArray() const { return std::holds_alternative<Array>(value); }
         bool isObject() const { return std::holds_alternative<Object>(value); }
+
+        // Underlying variant, for std::visit-style traversal
+        const ValueType& variant() const { return value; }
     
         bool asBool() const {
             if (!isBool()) throw std::runtime_error("JSONValue is not a boolean");
@@ -39,14 +188,38 @@ class JSONValue {
         }
     
         double asNumber() const {
-            if (!isNumber()) throw std::runtime_error("JSONValue is not a number");
-            return std::get<double>(value);
+            if (const auto* d = std::get_if<double>(&value)) return *d;
+            if (const auto* i = std::get_if<int64_t>(&value)) return static_cast<double>(*i);
+            if (const auto* u = std::get_if<uint64_t>(&value)) return static_cast<double>(*u);
+            throw std::runtime_error("JSONValue is not a number");
         }
     
-        const std::string& asString() const {
+        int64_t asInt64() const {
+            if (const auto* i = std::get_if<int64_t>(&value)) return *i;
+            if (const auto* u = std::get_if<uint64_t>(&value)) {
+                if (*u > static_cast<uint64_t>(INT64_MAX)) throw std::runtime_error("JSONValue does not fit in int64");
+                return static_cast<int64_t>(*u);
+            }
+            throw std::runtime_error("JSONValue is not an integer");
+        }
+    
+        uint64_t asUint64() const {
+            if (const auto* u = std::get_if<uint64_t>(&value)) return *u;
+            if (const auto* i = std::get_if<int64_t>(&value)) {
+                if (*i < 0) throw std::runtime_error("JSONValue does not fit in uint64");
+                return static_cast<uint64_t>(*i);
+            }
+            throw std::runtime_error("JSONValue is not an integer");
+        }
+    
+        // A std::pmr::string, so `std::string s = v.asString();` no longer compiles;
+        // asStringView() works wherever a std::string_view will do
+        const String& asString() const {
             if (!isString()) throw std::runtime_error("JSONValue is not a string");
-            return std::get<std::string>(value);
+            return std::get<String>(value);
         }
+
+        std::string_view asStringView() const { return asString(); }
     
         const Array& asArray() const {
             if (!isArray()) throw std::runtime_error("JSONValue is not an array");
@@ -68,7 +241,7 @@ class JSONValue {
             return std::get<Object>(value);
         }
     
-        const JSONValue& operator[](const std::string& key) const {
+        const JSONValue& operator[](std::string_view key) const {
             if (!isObject()) throw std::runtime_error("JSONValue is not an object");
             const auto& obj = std::get<Object>(value);
             auto it = obj.find(key);
@@ -76,7 +249,7 @@ class JSONValue {
             return (it != obj.end()) ? it->second : nullValue;
         }
     
-        JSONValue& operator[](const std::string& key) {
+        JSONValue& operator[](std::string_view key) {
             if (!isObject()) {
                 value = Object();
             }
@@ -101,24 +274,321 @@ class JSONValue {
             return arr[index];
         }
     };
+
+    // JSONObject members that need JSONValue to be complete
+    inline size_t JSONObject::size() const { return members.size(); }
+    inline bool JSONObject::empty() const { return members.empty(); }
+    inline JSONObject::iterator JSONObject::begin() { return members.data(); }
+    inline JSONObject::iterator JSONObject::end() { return members.data() + members.size(); }
+    inline JSONObject::const_iterator JSONObject::begin() const { return members.data(); }
+    inline JSONObject::const_iterator JSONObject::end() const { return members.data() + members.size(); }
+
+    inline JSONObject::iterator JSONObject::find(std::string_view key) { return begin() + findPosition(key); }
+    inline JSONObject::const_iterator JSONObject::find(std::string_view key) const { return begin() + findPosition(key); }
+    inline size_t JSONObject::count(std::string_view key) const { return findPosition(key) != size() ? 1 : 0; }
+    inline bool JSONObject::contains(std::string_view key) const { return findPosition(key) != size(); }
+
+    // Bump allocator for JSON documents. Deallocation is a no-op; reset() drops
+    // everything at once but keeps the memory, so reusing one arena across parses
+    // settles into a single block and stops calling malloc.
+    class JSONArena : public std::pmr::memory_resource {
+        public:
+            explicit JSONArena(size_t initialBytes = 64 * 1024);
+            ~JSONArena() override;
+
+            JSONArena(const JSONArena&) = delete;
+            JSONArena& operator=(const JSONArena&) = delete;
+
+            void reset();
+            size_t bytesUsed() const;
+            size_t bytesReserved() const;
+            size_t blockCount() const { return blocks.size(); }
+
+        private:
+            struct Block {
+                char* data;
+                size_t size;
+            };
+
+            std::vector<Block> blocks;
+            size_t offset = 0;    // Bump offset within blocks.back()
+            size_t usedBefore = 0; // Bytes consumed in all blocks but the last
+
+            void addBlock(size_t minBytes);
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void*, size_t, size_t) override {}
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+    };
+
+    // Symbol table for object keys. Keys longer than JSONKey::inlineCapacity are
+    // stored once and shared by every object that uses them, so a million records
+    // with the same fields keep one copy of each name. Values built with a table
+    // must not outlive it. A concurrent table can be shared by parsers on several threads.
+    class JSONKeyTable {
+        public:
+            explicit JSONKeyTable(bool concurrent = false) : concurrent(concurrent), storage(4096) {}
+
+            JSONKeyTable(const JSONKeyTable&) = delete;
+            JSONKeyTable& operator=(const JSONKeyTable&) = delete;
+
+            JSONKey intern(std::string_view key);
+
+            // Distinct long keys stored
+            size_t size() const;
+
+            // Invalidates every key handed out so far
+            void clear();
+
+        private:
+            bool concurrent;
+            mutable std::shared_mutex mutex;
+            JSONArena storage;
+            std::vector<std::string_view> slots;  // Open addressing; stored keys are never empty
+            size_t count = 0;
+
+            const std::string_view* lookup(std::string_view key, size_t hash) const;
+            void grow();
+    };
+
+    // Why a parse failed. Each code's message matches the text the throwing API reports.
+    enum class JSONErrorCode : uint8_t {
+        None,
+        UnexpectedEnd,
+        InvalidValue,
+        ExpectedKey,
+        ExpectedColon,
+        ExpectedCommaOrBrace,
+        ExpectedCommaOrBracket,
+        InvalidEscape,
+        InvalidUnicodeEscape,
+        UnterminatedEscape,
+        UnterminatedString,
+        ControlCharacter,
+        InvalidUTF8,
+        ExpectedDigit,
+        ExpectedFractionDigit,
+        ExpectedExponentDigit,
+        NumberOutOfRange,
+        InvalidKeyword,
+        TrailingData,
+        KeyTooLong,
+        DepthLimitExceeded,
+        OutOfMemory
+    };
+
+    const char* jsonErrorMessage(JSONErrorCode code) noexcept;
+
+    // Where a parse failed: offset is the 0-based byte, line and column are 1-based
+    // with columns counted in bytes. Line and column are only worked out on failure.
+    struct JSONError {
+        JSONErrorCode code = JSONErrorCode::None;
+        size_t offset = 0;
+        size_t line = 0;
+        size_t column = 0;
+
+        explicit operator bool() const { return code != JSONErrorCode::None; }
+        const char* message() const { return jsonErrorMessage(code); }
+
+        // "<message> at line L, column C"
+        std::string toString() const;
+    };
+
+    // Outcome of a non-throwing parse; value is null when error is set
+    struct JSONParseResult {
+        JSONValue value;
+        JSONError error;
+
+        bool ok() const { return !error; }
+    };
+
+    // What one parse, or every parse on every thread, spent its input, memory and
+    // time on. Object and array byte counts cover their whole text, nested values
+    // included; cycle counts are exclusive, so a phase does not include the values
+    // nested in it. Allocations are the ones made for the result tree.
+    struct JSONParseStats {
+        uint64_t documents = 0;
+        uint64_t failedDocuments = 0;
+        uint64_t inputBytes = 0;
+
+        uint64_t objects = 0;
+        uint64_t arrays = 0;
+        uint64_t strings = 0;
+        uint64_t keys = 0;
+        uint64_t numbers = 0;
+        uint64_t literals = 0;  // true, false and null
+
+        uint64_t objectBytes = 0;
+        uint64_t arrayBytes = 0;
+        uint64_t stringBytes = 0;
+        uint64_t keyBytes = 0;
+        uint64_t numberBytes = 0;
+        uint64_t literalBytes = 0;
+
+        uint64_t maxDepth = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+
+        // Time stamp counter ticks on x86, nanoseconds elsewhere
+        uint64_t stage1Cycles = 0;
+        uint64_t objectCycles = 0;
+        uint64_t arrayCycles = 0;
+        uint64_t stringCycles = 0;
+        uint64_t numberCycles = 0;
+        uint64_t totalCycles = 0;
+
+        // Adds other's counts; maxDepth keeps the larger of the two
+        void merge(const JSONParseStats& other);
+    };
+
     class JSONParser {
         private:
-            std::string json;
+            std::shared_ptr<const void> storage;  // Keeps copied or mapped input alive
+            std::string_view json;
             size_t index = 0;
-           
-            bool isEnd() const;  // Add this new method
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+            JSONKeyTable* keyTable = nullptr;   // Interns object keys when set
+            std::vector<uint32_t> structurals;  // Token offsets found by stage 1
+
+            // Members of the objects being parsed, so each object is built at its final size.
+            // A key is a range of the input, or of escapedKeys when it had to be decoded.
+            struct PendingMember {
+                size_t keyOffset;
+                size_t keyLength;
+                bool escaped;
+                JSONValue value;
+            };
+            std::vector<PendingMember> pendingMembers;
+            std::string escapedKeys;
+            size_t nextStructural = 0;
+            bool indexed = false;               // False when input is too large to index
+            JSONError error;                    // First failure of the current parse
+            size_t depth = 0;                   // Open objects and arrays
+            size_t maxDepth = defaultMaxDepth;
+            JSONParseStats stats;               // Of the current or last parse
+            uint64_t nestedCycles = 0;          // Spent in phases nested in the one being timed
+
+            class PhaseTimer;
+            bool leaveContainer(uint64_t& count, uint64_t& bytes, size_t start);
+            void finishStats(bool parsed, uint64_t started);
+
+            // Every step returns false once error is set, so a malformed document
+            // unwinds through plain returns instead of exceptions
+            bool isEnd() const;
             char peek() const;
-            char advance();
+            void advance();
             void skipWhitespace();
-            JSONValue parseValue();
-            JSONValue parseObject();
-            JSONValue parseArray();
-            JSONValue parseString();
-            JSONValue parseNumber();
-            JSONValue parseBoolOrNull();
+            bool fail(JSONErrorCode code);
+            bool failExpected(JSONErrorCode code);
+            bool parseValue(JSONValue& out);
+            bool parseObject(JSONValue& out);
+            bool parseArray(JSONValue& out);
+            bool parseString(JSONValue& out);
+            bool parseRawString(JSONValue::String& out);
+            bool parseKey(PendingMember& member);
+            bool parseKeyText(PendingMember& member);
+            bool parseNumber(JSONValue& out);
+            bool parseBoolOrNull(JSONValue& out);
+            bool parseDocument(JSONValue& out, std::pmr::memory_resource* memory, JSONKeyTable* keys);
            
         public:
+            static constexpr bool statsEnabled = JSON_PARSER_STATS != 0;
+
+            // Deeper input fails with DepthLimitExceeded instead of exhausting the stack
+            static constexpr size_t defaultMaxDepth = 1024;
+
+            // Copies the input; the parser owns its own buffer
             JSONParser(const std::string& jsonString);
+            JSONParser(std::string&& jsonString);
+            JSONParser(const char* jsonString);
+
+            // Zero-copy: the caller's buffer must outlive the parser
+            JSONParser(std::string_view jsonView);
+            JSONParser(const char* data, size_t length);
+
+            // An empty parser, to be pointed at input with reset()
+            JSONParser() = default;
+
+            // Maps the file read-only and parses it in place
+            static JSONParser fromFile(const std::string& path);
+
+            // Points the parser at new input without copying it. The index, member stack
+            // and key scratch space keep their capacity, so a long-lived parser stops
+            // allocating once it has seen its largest document.
+            void reset(std::string_view jsonView);
+
             JSONValue parse();
+
+            // Allocates every node, string and container of the result from resource,
+            // which must outlive the returned value
+            JSONValue parse(std::pmr::memory_resource* resource);
+
+            // As above, and object keys are interned in keys, which must outlive the value too
+            JSONValue parse(std::pmr::memory_resource* resource, JSONKeyTable* keys);
+
+            // Non-throwing forms of parse(). Malformed input, and running out of
+            // memory, come back as an error with its location; the parse()
+            // overloads throw std::runtime_error carrying the same text.
+            JSONParseResult tryParse() noexcept;
+            JSONParseResult tryParse(std::pmr::memory_resource* resource) noexcept;
+            JSONParseResult tryParse(std::pmr::memory_resource* resource, JSONKeyTable* keys) noexcept;
+
+            void setMaxDepth(size_t limit) { maxDepth = limit; }
+            size_t getMaxDepth() const { return maxDepth; }
+
+            // Statistics of the last parse; all zero unless statsEnabled
+            const JSONParseStats& lastStats() const { return stats; }
+
+            // Every parse on every thread since the last resetTotalStats(). Each
+            // thread adds its documents to its own counters without locking; this
+            // sums them.
+            static JSONParseStats totalStats();
+            static void resetTotalStats();
         };
+
+    // A parsed document whose whole tree lives in its own JSONArena.
+    // The tree is read-only, so it never owns memory outside the arena and
+    // release() can drop it in O(1) without walking the nodes. Object keys are
+    // interned in a table owned by the document.
+    class JSONDocument {
+        public:
+            explicit JSONDocument(size_t initialArenaBytes = 64 * 1024) : arena(initialArenaBytes) {}
+
+            JSONDocument(const JSONDocument&) = delete;
+            JSONDocument& operator=(const JSONDocument&) = delete;
+
+            // Releases the previous tree and parses a new one into the arena
+            const JSONValue& parse(JSONParser& parser);
+
+            // The same with a parser the document keeps. Arena, key table and parser
+            // buffers are all reused, so steady-state parsing makes no heap allocations.
+            // The tree does not refer to json, which may be released afterwards.
+            const JSONValue& parse(std::string_view json);
+
+            // Non-throwing forms of parse(). On failure the document is left empty.
+            JSONError tryParse(JSONParser& parser) noexcept;
+            JSONError tryParse(std::string_view json) noexcept;
+
+            // Parses each input in turn and hands its tree to handle, which must not keep
+            // it: the next input replaces it
+            void parseMany(const std::vector<std::string_view>& inputs,
+                           const std::function<void(size_t index, const JSONValue& root)>& handle);
+
+            const JSONValue& root() const;
+            bool empty() const { return rootValue == nullptr; }
+            void release();
+
+            const JSONArena& memory() const { return arena; }
+
+            // Applies to parses through the document's own parser
+            void setMaxDepth(size_t limit) { parser.setMaxDepth(limit); }
+            const JSONParseStats& lastStats() const { return parser.lastStats(); }
+
+        private:
+            JSONArena arena;
+            JSONKeyTable keys;
+            JSONParser parser;
+            const JSONValue* rootValue = nullptr;
+    };
         #endif 
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef JSON_PATCH_HPP
+#define JSON_PATCH_HPP
+#include "json_parser.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// An RFC 6902 JSON Patch: add, remove, replace, move, copy and test operations
+// addressed by RFC 6901 pointers. Pointers are split into tokens when an
+// operation is added, and apply() edits the document in place: each operation
+// costs a lookup per pointer token, plus a shift of the later elements or
+// members when it inserts into an array or removes from an array or object,
+// since order is kept. The rest of the document is never touched. Values are
+// moved into the document, and move operations relink the subtree rather than
+// copying it.
+class JSONPatch {
+    public:
+        enum class Op { Add, Remove, Replace, Move, Copy, Test };
+
+        struct Operation {
+            Op op = Op::Add;
+            std::string path;
+            std::string from;   // Move and Copy
+            JSONValue value;    // Add, Replace and Test
+
+            std::vector<std::string> pathTokens;  // Unescaped pointer tokens
+            std::vector<std::string> fromTokens;
+        };
+
+        JSONPatch() = default;
+
+        // Reads a patch document (an array of operation objects); throws std::runtime_error if it is malformed
+        static JSONPatch fromJSON(const JSONValue& patch);
+        static JSONPatch parse(std::string_view json);
+
+        // The patch that turns from into to. Objects are compared member by
+        // member and arrays element by element after trimming their common
+        // prefix and suffix; only values that differ are copied into the patch.
+        static JSONPatch diff(const JSONValue& from, const JSONValue& to);
+
+        JSONPatch& add(std::string_view path, JSONValue value);
+        JSONPatch& remove(std::string_view path);
+        JSONPatch& replace(std::string_view path, JSONValue value);
+        JSONPatch& move(std::string_view from, std::string_view path);
+        JSONPatch& copy(std::string_view from, std::string_view path);
+        JSONPatch& test(std::string_view path, JSONValue value);
+
+        // Applies the operations in order. The first one that fails throws
+        // std::runtime_error naming its index; the operations before it stay applied.
+        void apply(JSONValue& document) const&;
+
+        // Moves each operation's value into the document instead of copying it;
+        // the patch is left without values
+        void apply(JSONValue& document) &&;
+
+        const std::vector<Operation>& operations() const { return ops; }
+        size_t size() const { return ops.size(); }
+        bool empty() const { return ops.empty(); }
+
+        JSONValue toJSON() const;
+        std::string toString(int indent = 0) const;
+
+    private:
+        std::vector<Operation> ops;
+
+        JSONPatch& append(Op op, std::string_view from, std::string_view path, JSONValue value);
+};
+
+// Structural equality as RFC 6902 "test" defines it: numbers compare by exact
+// value, so 1 equals 1.0 but 2^53 + 1 does not equal the double 2^53, and
+// objects ignore member order
+bool jsonEquals(const JSONValue& a, const JSONValue& b);
+
+#endif
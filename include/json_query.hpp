@@ -0,0 +1,70 @@
+#ifndef JSON_QUERY_HPP
+#define JSON_QUERY_HPP
+#include "json_lazy.hpp"
+#include "json_parser.hpp"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// A query compiled once and run many times. Two syntaxes compile to the same plan:
+//
+//   JSON Pointer (RFC 6901)   /events/0/user/id    ~0 and ~1 escape '~' and '/'
+//   JSONPath subset           $.events[*].user.id
+//                             $['key'], [2], [-1], .*, [*]
+//                             [?(@.type == 'click')], [?(@.user.id >= 10)], [?(@.flag)]
+//
+// Keys are decoded and stored when the query is compiled, so running a plan
+// builds no strings. Plans run against the JSONValue DOM, or against raw text
+// through the lazy index, where only the matches are ever decoded.
+class JSONQuery {
+    public:
+        static JSONQuery pointer(std::string_view pointer);
+        static JSONQuery path(std::string_view expression);
+
+        // True when the query can match at most one value (no wildcards or filters)
+        bool isSingular() const;
+
+        // First match, or nullptr
+        const JSONValue* find(const JSONValue& root) const;
+        std::vector<const JSONValue*> findAll(const JSONValue& root) const;
+        void forEach(const JSONValue& root, const std::function<void(const JSONValue&)>& visit) const;
+
+        // The same over a lazy document, with repeated keys resolved as in the DOM;
+        // find() returns a handle whose exists() is false on no match
+        JSONLazyValue find(JSONLazyValue root) const;
+        void forEach(JSONLazyValue root, const std::function<void(JSONLazyValue)>& visit) const;
+
+        // Runs on the raw input without building a DOM: subtrees off the path are
+        // skipped unread and only the matching values are parsed
+        std::vector<JSONValue> extract(std::string_view json) const;
+
+    private:
+        enum class StepKind { Key, Index, KeyOrIndex, Wildcard, Filter };
+        enum class FilterOp { Exists, Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+        struct Step {
+            StepKind kind = StepKind::Key;
+            JSONValue::String key;  // Key, KeyOrIndex
+            int64_t index = 0;      // Index (negative counts from the end), KeyOrIndex (-1 when not an index)
+
+            // Filter: keys from '@' to the tested value, the operator and its operand
+            std::vector<JSONValue::String> filterPath;
+            FilterOp op = FilterOp::Exists;
+            JSONValue operand;
+        };
+
+        std::vector<Step> steps;
+
+        bool walk(const JSONValue& value, size_t step, const std::function<bool(const JSONValue&)>& visit) const;
+        bool walk(JSONLazyValue value, size_t step, const std::function<bool(JSONLazyValue)>& visit) const;
+
+        template <typename Value>
+        static bool compare(const Step& step, const Value& target);
+        static bool matches(const Step& step, const JSONValue& element);
+        static bool matches(const Step& step, JSONLazyValue element);
+
+        friend class JSONPathCompiler;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef JSON_READER_HPP
+#define JSON_READER_HPP
+#include "json_parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json_detail {
+struct ParsedNumber;
+}
+
+// Pull parser over a JSON buffer: the caller asks for the value it expects next
+// and the reader decodes it in place, with no tree built in between. It accepts
+// exactly what JSONParser does and reports errors the way JSONStreamParser does,
+// with the byte offset appended.
+class JSONReader {
+    public:
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        // Zero-copy: the buffer must outlive the reader
+        explicit JSONReader(std::string_view json);
+
+        // Type of the next value, without consuming it
+        Type peekType();
+
+        // True when the next value is null, which is then consumed; anything else is left unread
+        bool readNull();
+        bool readBool();
+        double readDouble();
+        int64_t readInt64();
+        uint64_t readUint64();
+
+        // Points into the input when the string has no escapes, otherwise into a
+        // scratch buffer that the next read overwrites
+        std::string_view readString();
+
+        // Objects: beginObject(), then read one value after each nextKey() that returns true.
+        // Opening a container nested deeper than the limit throws instead of
+        // letting skipValue() exhaust the stack.
+        void beginObject();
+        bool nextKey(std::string_view& key);
+
+        // Arrays: beginArray(), then read one value after each nextElement() that returns true
+        void beginArray();
+        bool nextElement();
+
+        // Validates the next value and steps over it
+        void skipValue();
+
+        // Validates the next value, steps over it and returns its text
+        std::string_view readRaw();
+
+        // Throws unless only whitespace remains
+        void finish();
+
+        size_t offset() const { return index; }
+
+        void setMaxDepth(size_t limit) { maxDepth = limit; }
+        size_t getMaxDepth() const { return maxDepth; }
+
+        // Throws std::runtime_error with message and the current byte offset
+        [[noreturn]] void fail(const std::string& message) const;
+
+    private:
+        std::string_view json;
+        size_t index = 0;
+        std::string scratch;
+        std::vector<bool> firstItem;  // One entry per open container
+        size_t maxDepth = JSONParser::defaultMaxDepth;
+
+        char peekSignificant();
+        void expectDelimiter();
+        void openContainer();
+        void readNumber(json_detail::ParsedNumber& number);
+        void readLiteral(std::string_view literal);
+        [[noreturn]] void failAt(const char* message, const char* at) const;
+};
+
+#endif
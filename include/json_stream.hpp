@@ -0,0 +1,91 @@
+#ifndef JSON_STREAM_HPP
+#define JSON_STREAM_HPP
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Receives SAX-style events from JSONStreamParser. Every callback has an empty
+// default, so handlers only override what they need. String views are only
+// valid for the duration of the callback.
+class JSONHandler {
+    public:
+        virtual ~JSONHandler() = default;
+
+        virtual void onStartObject() {}
+        virtual void onKey(std::string_view) {}
+        virtual void onEndObject() {}
+        virtual void onStartArray() {}
+        virtual void onEndArray() {}
+        virtual void onString(std::string_view) {}
+        virtual void onNumber(double) {}
+        virtual void onInt64(int64_t value) { onNumber(static_cast<double>(value)); }
+        virtual void onUint64(uint64_t value) { onNumber(static_cast<double>(value)); }
+        virtual void onBool(bool) {}
+        virtual void onNull() {}
+};
+
+// Event-driven parser that accepts input in arbitrary chunks. Parsing state is
+// kept between feed() calls, so a token may be split anywhere; memory use depends
+// on nesting depth and the longest string, never on document size.
+class JSONStreamParser {
+    public:
+        explicit JSONStreamParser(JSONHandler& handler) : handler(handler) {}
+
+        // Parses the next chunk of input; throws std::runtime_error on malformed JSON
+        void feed(const char* data, size_t length);
+        void feed(std::string_view chunk) { feed(chunk.data(), chunk.size()); }
+
+        // Signals end of input; throws if the document is incomplete
+        void finish();
+
+        // Prepares the parser for a new document, keeping its buffers
+        void reset();
+
+        // Reads the whole input in chunkSize pieces and finishes the document
+        void parse(std::istream& in, size_t chunkSize = 64 * 1024);
+        void parse(int fd, size_t chunkSize = 64 * 1024);
+
+        size_t bytesConsumed() const { return consumed; }
+        size_t depth() const { return containers.size(); }
+
+    private:
+        enum class State : uint8_t {
+            Value,            // any value
+            FirstValueOrEnd,  // after '['
+            FirstKeyOrEnd,    // after '{'
+            Key,              // after ',' in an object
+            Colon,            // after a key
+            AfterValue,       // ',' or the closing bracket
+            Done,             // top-level value complete
+            String,
+            Number,
+            Literal
+        };
+
+        JSONHandler& handler;
+        State state = State::Value;
+        std::vector<char> containers;  // '{' or '[' per open level
+        std::string token;             // partial token carried across chunks
+        std::string scratch;           // decoded string with escapes
+        bool stringIsKey = false;
+        bool escapePending = false;
+        bool stringHasEscape = false;
+        size_t consumed = 0;           // bytes fed before the current chunk
+        const char* chunkStart = nullptr;
+
+        const char* startValue(const char* p);
+        const char* continueString(const char* p, const char* end);
+        const char* continueNumber(const char* p, const char* end);
+        const char* continueLiteral(const char* p, const char* end);
+        void emitString(std::string_view raw, const char* errorAt);
+        void emitNumber(std::string_view text, const char* errorAt);
+        void emitLiteral(std::string_view text, const char* errorAt);
+        void endContainer(char open);
+        void valueCompleted();
+        [[noreturn]] void fail(const char* message, const char* at) const;
+};
+
+#endif
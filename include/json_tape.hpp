@@ -0,0 +1,173 @@
+#ifndef JSON_TAPE_HPP
+#define JSON_TAPE_HPP
+#include "json_parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class JSONTape;
+
+// Handle to one value on a JSONTape. Copying a handle is free; it stays valid
+// until the tape is modified, moved or destroyed.
+class JSONTapeValue {
+    public:
+        JSONTapeValue() = default;
+
+        // False for the handle returned when an object key is missing
+        bool exists() const { return tape != nullptr; }
+
+        // A missing key reads as null, like JSONValue::operator[]
+        bool isNull() const;
+        bool isBool() const;
+        bool isNumber() const;
+        bool isInteger() const;
+        bool isString() const;
+        bool isArray() const;
+        bool isObject() const;
+
+        bool asBool() const;
+        double asNumber() const;
+        int64_t asInt64() const;
+        uint64_t asUint64() const;
+        std::string_view asString() const;  // Points into the tape's string buffer
+
+        // Linear in the number of members; nested values are skipped in O(1). A
+        // repeated key reads as its last value, as JSONValue keeps it.
+        JSONTapeValue operator[](std::string_view key) const;
+        JSONTapeValue operator[](size_t index) const;
+
+        // Number of array elements or distinct object keys, O(1) below the tape's count limit
+        size_t size() const;
+
+        // visit(JSONTapeValue) for each element, in order
+        template <typename Visit>
+        void forEachElement(Visit&& visit) const;
+
+        // visit(std::string_view key, JSONTapeValue value) for each member, in order. A
+        // repeated key is visited once, at its first position, with its last value.
+        template <typename Visit>
+        void forEachField(Visit&& visit) const;
+
+        // Rebuilds this value and its subtree as a JSONValue. Throws if containers
+        // nest deeper than JSONParser::defaultMaxDepth.
+        JSONValue toValue() const;
+
+    private:
+        friend class JSONTape;
+
+        const JSONTape* tape = nullptr;
+        size_t position = 0;  // Index of the value's first word
+
+        JSONTapeValue(const JSONTape* tape, size_t position) : tape(tape), position(position) {}
+
+        char tag() const;
+        uint64_t payload() const;
+        JSONValue toValue(size_t depth) const;
+        void distinctMembers(std::vector<std::pair<std::string_view, size_t>>& members) const;
+        size_t containerEnd(char open, const char* message) const;
+};
+
+// Read-only document stored as one contiguous tape of tagged 64-bit words plus a
+// string buffer. Each word keeps its type in the top byte and a 56-bit payload:
+//
+//   n t f             null, true, false
+//   l u d             int64, uint64, double; the value is in the next word
+//   "                 offset of a 4-byte length and the bytes in the string buffer
+//   [ {               index just past the matching close (low 32 bits), member count (high 24)
+//   ] }               index of the matching open
+//
+// Walking the tape touches memory in order, and a container's end index lets
+// a whole subtree be skipped in O(1).
+class JSONTape {
+    public:
+        JSONTape() = default;
+        explicit JSONTape(std::string_view json) { parse(json); }
+
+        // Copies a DOM tree onto a new tape
+        static JSONTape fromValue(const JSONValue& value);
+
+        // Replace the contents, keeping the buffers' capacity
+        void parse(std::string_view json);
+        void parse(std::istream& in);
+        void assign(const JSONValue& value);
+        void clear();
+
+        JSONTapeValue root() const;
+        JSONValue toValue() const { return root().toValue(); }
+        bool empty() const { return words.empty(); }
+
+        // Counts below the limit are stored in each container's word; larger ones
+        // are recounted by walking. The field is 24 bits wide, so the limit can only
+        // be lowered, mainly so tests can reach the fallback. Clears the tape.
+        static constexpr size_t maxCountLimit = 0xFFFFFF;
+        void setCountLimit(size_t limit) {
+            clear();
+            countLimit = limit < maxCountLimit ? limit : maxCountLimit;
+        }
+        size_t getCountLimit() const { return countLimit; }
+
+        size_t wordCount() const { return words.size(); }
+        size_t stringBytes() const { return strings.size(); }
+        // Bytes held by both buffers, including spare capacity
+        size_t memoryUsage() const { return words.capacity() * sizeof(uint64_t) + strings.capacity(); }
+
+    private:
+        friend class JSONTapeValue;
+        friend class JSONTapeBuilder;
+
+        std::vector<uint64_t> words;
+        std::string strings;
+        size_t countLimit = maxCountLimit;
+
+        // Index of the word after the value starting at position
+        size_t skip(size_t position) const {
+            uint64_t word = words[position];
+            switch (static_cast<char>(word >> 56)) {
+                case '[': case '{': return static_cast<size_t>(word & 0xFFFFFFFF);
+                case 'l': case 'u': case 'd': return position + 2;
+                default: return position + 1;
+            }
+        }
+};
+
+inline char JSONTapeValue::tag() const {
+    return tape ? static_cast<char>(tape->words[position] >> 56) : 'n';
+}
+
+inline bool JSONTapeValue::isNull() const { return tag() == 'n'; }
+inline bool JSONTapeValue::isBool() const { return tag() == 't' || tag() == 'f'; }
+inline bool JSONTapeValue::isNumber() const { return tag() == 'l' || tag() == 'u' || tag() == 'd'; }
+inline bool JSONTapeValue::isInteger() const { return tag() == 'l' || tag() == 'u'; }
+inline bool JSONTapeValue::isString() const { return tag() == '"'; }
+inline bool JSONTapeValue::isArray() const { return tag() == '['; }
+inline bool JSONTapeValue::isObject() const { return tag() == '{'; }
+
+template <typename Visit>
+void JSONTapeValue::forEachElement(Visit&& visit) const {
+    size_t close = containerEnd('[', "JSONTapeValue is not an array");
+    for (size_t p = position + 1; p < close; p = tape->skip(p)) visit(JSONTapeValue(tape, p));
+}
+
+template <typename Visit>
+void JSONTapeValue::forEachField(Visit&& visit) const {
+    size_t close = containerEnd('{', "JSONTapeValue is not an object");
+    // The stored count has one member per distinct key, so only objects that
+    // repeat a key take the slower path
+    size_t members = 0;
+    for (size_t p = position + 1; p < close; p = tape->skip(p + 1)) members++;
+    if (members != size()) {
+        std::vector<std::pair<std::string_view, size_t>> distinct;
+        distinctMembers(distinct);
+        for (const auto& [key, value] : distinct) visit(key, JSONTapeValue(tape, value));
+        return;
+    }
+    for (size_t p = position + 1; p < close; p = tape->skip(p + 1)) {
+        visit(JSONTapeValue(tape, p).asString(), JSONTapeValue(tape, p + 1));
+    }
+}
+
+#endif
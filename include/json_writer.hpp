@@ -0,0 +1,63 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+#include "json_parser.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Serializes JSONValue trees, or a stream of write calls, to JSON text.
+// The output buffer is kept between calls, so a long-lived writer stops
+// allocating once it has grown to the largest document it has produced.
+class JSONWriter {
+    public:
+        // indent == 0 writes compact JSON; otherwise each level is indented by that many spaces
+        explicit JSONWriter(int indent = 0) : indent(indent) {}
+
+        // Serializes value into the writer's buffer and returns it
+        const std::string& write(const JSONValue& value);
+
+        // Serializes value to out, flushing the buffer in large chunks
+        void write(const JSONValue& value, std::ostream& out);
+
+        static std::string toString(const JSONValue& value, int indent = 0);
+
+        // Streaming interface: commas, colons and indentation are inserted automatically
+        JSONWriter& beginObject();
+        JSONWriter& endObject();
+        JSONWriter& beginArray();
+        JSONWriter& endArray();
+        JSONWriter& writeKey(std::string_view key);
+        JSONWriter& writeNull();
+        JSONWriter& writeBool(bool b);
+        JSONWriter& writeDouble(double d);
+        JSONWriter& writeInt64(int64_t i);
+        JSONWriter& writeUint64(uint64_t u);
+        JSONWriter& writeString(std::string_view s);
+        JSONWriter& writeValue(const JSONValue& value);
+
+        const std::string& str() const { return buffer; }
+        void clear();
+
+        // Appends s as a quoted JSON string, escaping only what JSON requires
+        static void appendEscaped(std::string& out, std::string_view s);
+
+    private:
+        struct Level {
+            bool isObject;
+            bool hasItems;
+        };
+
+        int indent;
+        std::string buffer;
+        std::vector<Level> levels;
+        bool afterKey = false;
+        std::ostream* sink = nullptr;
+
+        void beforeValue();
+        void newline();
+        void spill();
+};
+
+#endif
@@ -0,0 +1,381 @@
+#include "json_lazy.hpp"
+#include "json_mmap.hpp"
+#include "json_number.hpp"
+#include "json_stage1.hpp"
+#include "json_string.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Grammar states for the structure pass over the token list
+enum class Expect {
+    Value,
+    FirstValueOrEnd,
+    FirstKeyOrEnd,
+    Key,
+    Colon,
+    AfterValue
+};
+
+inline bool isScalarStart(char ch) {
+    return ch == '"' || ch == '-' || json_detail::isDigit(ch) || ch == 't' || ch == 'f' || ch == 'n';
+}
+
+void throwStringError(json_detail::StringError error) {
+    switch (error) {
+        case json_detail::StringError::None: break;
+        case json_detail::StringError::InvalidEscape: throw std::runtime_error("Invalid escape sequence");
+        case json_detail::StringError::InvalidUnicodeEscape: throw std::runtime_error("Invalid \\u escape");
+        case json_detail::StringError::UnterminatedEscape: throw std::runtime_error("Unterminated escape sequence");
+        case json_detail::StringError::Unterminated: throw std::runtime_error("Unterminated string");
+        case json_detail::StringError::ControlCharacter: throw std::runtime_error("Unescaped control character in string");
+        case json_detail::StringError::InvalidUTF8: throw std::runtime_error("Invalid UTF-8 in string");
+    }
+}
+
+// Decodes the string whose opening quote is at json[quote]
+void decodeAt(std::string_view json, size_t quote, std::string& out) {
+    out.clear();
+    const char* end = nullptr;
+    throwStringError(json_detail::decodeString(json.data() + quote + 1, json.data() + json.size(), out, end));
+}
+
+// Compares the key whose opening quote is at json[quote] with key. The key's text
+// ends before limit (the ':' that follows it). Keys without escapes are compared
+// in place; only escaped keys are decoded into scratch.
+bool keyEquals(std::string_view json, size_t quote, size_t limit, std::string_view key, bool keyIsPlain,
+               std::string& scratch) {
+    const char* text = json.data() + quote + 1;
+    size_t available = limit - quote - 1;
+    if (keyIsPlain && !std::memchr(text, '\\', available)) {
+        return key.size() < available && text[key.size()] == '"' && std::memcmp(text, key.data(), key.size()) == 0;
+    }
+    decodeAt(json, quote, scratch);
+    return scratch == key;
+}
+
+} // namespace
+
+// Constructors that copy the input into document-owned storage
+JSONLazyDocument::JSONLazyDocument(const std::string& jsonString) : JSONLazyDocument(std::string(jsonString)) {}
+
+JSONLazyDocument::JSONLazyDocument(std::string&& jsonString) {
+    auto owned = std::make_shared<const std::string>(std::move(jsonString));
+    json = *owned;
+    storage = std::move(owned);
+    buildIndex();
+}
+
+JSONLazyDocument::JSONLazyDocument(const char* jsonString) : JSONLazyDocument(std::string(jsonString)) {}
+
+// Zero-copy constructors that index the caller's buffer in place
+JSONLazyDocument::JSONLazyDocument(std::string_view jsonView) : json(jsonView) {
+    buildIndex();
+}
+
+JSONLazyDocument::JSONLazyDocument(const char* data, size_t length) : json(data, length) {
+    buildIndex();
+}
+
+JSONLazyDocument::JSONLazyDocument(std::shared_ptr<const void> storage, std::string_view json)
+    : storage(std::move(storage)), json(json) {
+    buildIndex();
+}
+
+// Maps a file read-only and indexes it without copying
+JSONLazyDocument JSONLazyDocument::fromFile(const std::string& path) {
+    auto mapped = std::make_shared<const json_detail::MappedFile>(path);
+    std::string_view view = mapped->view();
+    return JSONLazyDocument(std::move(mapped), view);
+}
+
+// Runs stage 1, then checks the token sequence against the JSON grammar and
+// records the matching close of every object and array
+void JSONLazyDocument::buildIndex() {
+    if (json.size() > json_detail::maxStructuralInput) throw std::runtime_error("Input too large for lazy parsing");
+    json_detail::findStructurals(json.data(), json.size(), structurals);
+    closers.assign(structurals.size(), 0);
+
+    std::vector<uint32_t> open;
+    Expect expect = Expect::Value;
+    for (uint32_t i = 0; i < structurals.size(); i++) {
+        char ch = json[structurals[i]];
+        bool closes = false;
+        switch (expect) {
+            case Expect::FirstValueOrEnd:
+                if (ch == ']') {
+                    closes = true;
+                    break;
+                }
+                [[fallthrough]];
+            case Expect::Value:
+                if (ch == '{' || ch == '[') {
+                    open.push_back(i);
+                    expect = ch == '{' ? Expect::FirstKeyOrEnd : Expect::FirstValueOrEnd;
+                } else if (isScalarStart(ch)) {
+                    expect = Expect::AfterValue;
+                } else {
+                    throw std::runtime_error("Invalid JSON value");
+                }
+                break;
+            case Expect::FirstKeyOrEnd:
+                if (ch == '}') {
+                    closes = true;
+                    break;
+                }
+                [[fallthrough]];
+            case Expect::Key:
+                if (ch != '"') throw std::runtime_error("Expected string key in object");
+                expect = Expect::Colon;
+                break;
+            case Expect::Colon:
+                if (ch != ':') throw std::runtime_error("Expected ':' after key");
+                expect = Expect::Value;
+                break;
+            case Expect::AfterValue:
+                if (open.empty()) throw std::runtime_error("Unexpected data after JSON value");
+                if (json[structurals[open.back()]] == '{') {
+                    if (ch == ',') expect = Expect::Key;
+                    else if (ch == '}') closes = true;
+                    else throw std::runtime_error("Expected ',' or '}' after value in object");
+                } else {
+                    if (ch == ',') expect = Expect::Value;
+                    else if (ch == ']') closes = true;
+                    else throw std::runtime_error("Expected ',' or ']' after value in array");
+                }
+                break;
+        }
+        if (closes) {
+            closers[open.back()] = i;
+            open.pop_back();
+            expect = Expect::AfterValue;
+        }
+    }
+    if (expect != Expect::AfterValue || !open.empty()) throw std::runtime_error("Unexpected end of input");
+}
+
+// Index of the token after the value starting at token
+uint32_t JSONLazyDocument::skip(uint32_t token) const {
+    char ch = json[structurals[token]];
+    return (ch == '{' || ch == '[') ? closers[token] + 1 : token + 1;
+}
+
+// Offset where the next token starts, which bounds a scalar's text
+size_t JSONLazyDocument::tokenEnd(uint32_t token) const {
+    return token + 1 < structurals.size() ? structurals[token + 1] : json.size();
+}
+
+char JSONLazyValue::firstChar() const {
+    return document ? document->json[document->tokenOffset(token)] : 'n';
+}
+
+bool JSONLazyValue::isNull() const { return !document || firstChar() == 'n'; }
+bool JSONLazyValue::isBool() const { return document && (firstChar() == 't' || firstChar() == 'f'); }
+bool JSONLazyValue::isNumber() const { return document && (firstChar() == '-' || json_detail::isDigit(firstChar())); }
+bool JSONLazyValue::isString() const { return document && firstChar() == '"'; }
+bool JSONLazyValue::isArray() const { return document && firstChar() == '['; }
+bool JSONLazyValue::isObject() const { return document && firstChar() == '{'; }
+
+bool JSONLazyValue::isInteger() const {
+    if (!isNumber()) return false;
+    json_detail::ParsedNumber number;
+    parseNumber(number);
+    return number.kind != json_detail::NumberKind::Double;
+}
+
+// Parses the number token in place, rejecting anything glued to its end
+void JSONLazyValue::parseNumber(json_detail::ParsedNumber& number) const {
+    if (!isNumber()) throw std::runtime_error("JSONLazyValue is not a number");
+    const char* first = document->json.data() + document->tokenOffset(token);
+    const char* last = document->json.data() + document->tokenEnd(token);
+    const char* end = nullptr;
+    switch (json_detail::parseNumber(first, last, number, end)) {
+        case json_detail::NumberError::None: break;
+        case json_detail::NumberError::ExpectedDigit: throw std::runtime_error("Expected digit");
+        case json_detail::NumberError::ExpectedFractionDigit: throw std::runtime_error("Expected digit after decimal point");
+        case json_detail::NumberError::ExpectedExponentDigit: throw std::runtime_error("Expected digit in exponent");
+        case json_detail::NumberError::OutOfRange: throw std::runtime_error("Number out of range");
+    }
+    if (end != last && !json_detail::isJSONWhitespace(*end)) throw std::runtime_error("Unexpected character after value");
+}
+
+// Validates a true/false/null token against its spelling
+void JSONLazyValue::checkLiteral(std::string_view literal) const {
+    if (rawJSON() != literal) throw std::runtime_error("Invalid JSON keyword");
+}
+
+bool JSONLazyValue::asBool() const {
+    if (!isBool()) throw std::runtime_error("JSONLazyValue is not a boolean");
+    bool value = firstChar() == 't';
+    checkLiteral(value ? "true" : "false");
+    return value;
+}
+
+double JSONLazyValue::asNumber() const {
+    json_detail::ParsedNumber number;
+    parseNumber(number);
+    switch (number.kind) {
+        case json_detail::NumberKind::Int64: return static_cast<double>(number.i);
+        case json_detail::NumberKind::Uint64: return static_cast<double>(number.u);
+        case json_detail::NumberKind::Double: break;
+    }
+    return number.d;
+}
+
+int64_t JSONLazyValue::asInt64() const {
+    json_detail::ParsedNumber number;
+    parseNumber(number);
+    switch (number.kind) {
+        case json_detail::NumberKind::Int64: return number.i;
+        case json_detail::NumberKind::Uint64:
+            if (number.u > static_cast<uint64_t>(INT64_MAX)) throw std::runtime_error("JSONLazyValue does not fit in int64");
+            return static_cast<int64_t>(number.u);
+        case json_detail::NumberKind::Double: break;
+    }
+    throw std::runtime_error("JSONLazyValue is not an integer");
+}
+
+uint64_t JSONLazyValue::asUint64() const {
+    json_detail::ParsedNumber number;
+    parseNumber(number);
+    switch (number.kind) {
+        case json_detail::NumberKind::Uint64: return number.u;
+        case json_detail::NumberKind::Int64:
+            if (number.i < 0) throw std::runtime_error("JSONLazyValue does not fit in uint64");
+            return static_cast<uint64_t>(number.i);
+        case json_detail::NumberKind::Double: break;
+    }
+    throw std::runtime_error("JSONLazyValue is not an integer");
+}
+
+std::string JSONLazyValue::asString() const {
+    if (!isString()) throw std::runtime_error("JSONLazyValue is not a string");
+    std::string out;
+    decodeAt(document->json, document->tokenOffset(token), out);
+    return out;
+}
+
+void JSONLazyValue::requireKind(char open, const char* message) const {
+    if (!document || firstChar() != open) throw std::runtime_error(message);
+}
+
+JSONLazyValue JSONLazyValue::operator[](std::string_view key) const {
+    requireKind('{', "JSONLazyValue is not an object");
+    const JSONLazyDocument& doc = *document;
+    bool keyIsPlain = key.find_first_of("\"\\") == std::string_view::npos;
+    std::string scratch;
+
+    // Each member is key, ':', value; the value is skipped without being read.
+    // The scan runs to the end, since a repeated key's last value wins, as in the DOM.
+    JSONLazyValue found;
+    uint32_t keyToken = token + 1;
+    if (doc.json[doc.tokenOffset(keyToken)] == '}') return found;
+    while (true) {
+        uint32_t valueToken = keyToken + 2;
+        if (keyEquals(doc.json, doc.tokenOffset(keyToken), doc.tokenOffset(keyToken + 1), key, keyIsPlain, scratch)) {
+            found = JSONLazyValue(document, valueToken);
+        }
+        uint32_t next = doc.skip(valueToken);
+        if (doc.json[doc.tokenOffset(next)] == '}') return found;
+        keyToken = next + 1;
+    }
+}
+
+// Objects with repeated keys read as the DOM would build them: each key once, at
+// its first position, with the last value given for it
+void JSONLazyValue::distinctMembers(std::vector<std::pair<std::string, uint32_t>>& members) const {
+    requireKind('{', "JSONLazyValue is not an object");
+    const JSONLazyDocument& doc = *document;
+    members.clear();
+    std::unordered_map<std::string, size_t> positions;  // Filled once the object outgrows linear search
+    uint32_t keyToken = token + 1;
+    if (doc.json[doc.tokenOffset(keyToken)] == '}') return;
+    std::string key;
+    while (true) {
+        decodeAt(doc.json, doc.tokenOffset(keyToken), key);
+        uint32_t valueToken = keyToken + 2;
+        size_t position = members.size();
+        if (members.size() <= JSONObject::linearLimit) {
+            for (size_t i = 0; i < members.size(); i++) {
+                if (members[i].first == key) position = i;
+            }
+        } else {
+            if (positions.empty()) {
+                for (size_t i = 0; i < members.size(); i++) positions.emplace(members[i].first, i);
+            }
+            auto [it, inserted] = positions.emplace(key, members.size());
+            if (!inserted) position = it->second;
+        }
+        if (position == members.size()) members.emplace_back(key, valueToken);
+        else members[position].second = valueToken;
+
+        uint32_t next = doc.skip(valueToken);
+        if (doc.json[doc.tokenOffset(next)] == '}') return;
+        keyToken = next + 1;
+    }
+}
+
+JSONLazyValue JSONLazyValue::operator[](size_t index) const {
+    requireKind('[', "JSONLazyValue is not an array");
+    const JSONLazyDocument& doc = *document;
+    uint32_t element = token + 1;
+    if (doc.json[doc.tokenOffset(element)] == ']') throw std::runtime_error("Array index out of bounds");
+    for (size_t i = 0; i < index; i++) {
+        uint32_t next = doc.skip(element);
+        if (doc.json[doc.tokenOffset(next)] == ']') throw std::runtime_error("Array index out of bounds");
+        element = next + 1;
+    }
+    return JSONLazyValue(document, element);
+}
+
+size_t JSONLazyValue::size() const {
+    size_t count = 0;
+    if (isArray()) {
+        forEachElement([&](JSONLazyValue) { count++; });
+    } else if (isObject()) {
+        std::vector<std::pair<std::string, uint32_t>> members;
+        distinctMembers(members);
+        count = members.size();
+    } else {
+        throw std::runtime_error("JSONLazyValue is not an array or object");
+    }
+    return count;
+}
+
+void JSONLazyValue::forEachElement(const std::function<void(JSONLazyValue)>& visit) const {
+    requireKind('[', "JSONLazyValue is not an array");
+    const JSONLazyDocument& doc = *document;
+    uint32_t element = token + 1;
+    if (doc.json[doc.tokenOffset(element)] == ']') return;
+    while (true) {
+        visit(JSONLazyValue(document, element));
+        uint32_t next = doc.skip(element);
+        if (doc.json[doc.tokenOffset(next)] == ']') return;
+        element = next + 1;
+    }
+}
+
+void JSONLazyValue::forEachField(const std::function<void(const std::string&, JSONLazyValue)>& visit) const {
+    std::vector<std::pair<std::string, uint32_t>> members;
+    distinctMembers(members);
+    for (const auto& [key, valueToken] : members) visit(key, JSONLazyValue(document, valueToken));
+}
+
+std::string_view JSONLazyValue::rawJSON() const {
+    if (!document) return std::string_view();
+    const JSONLazyDocument& doc = *document;
+    size_t first = doc.tokenOffset(token);
+    if (isArray() || isObject()) {
+        return doc.json.substr(first, doc.tokenOffset(doc.closers[token]) + 1 - first);
+    }
+    size_t last = doc.tokenEnd(token);
+    while (last > first && json_detail::isJSONWhitespace(doc.json[last - 1])) last--;
+    return doc.json.substr(first, last - first);
+}
+
+JSONValue JSONLazyValue::materialize() const {
+    if (!document) return JSONValue();
+    return JSONParser(rawJSON()).parse();
+}
@@ -0,0 +1,27 @@
+#ifndef JSON_MMAP_HPP
+#define JSON_MMAP_HPP
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace json_detail {
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view view() const { return std::string_view(data ? data : "", size); }
+
+    private:
+        const char* data = nullptr;
+        size_t size = 0;
+};
+
+} // namespace json_detail
+
+#endif
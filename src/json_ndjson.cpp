@@ -0,0 +1,124 @@
+#include "json_ndjson.hpp"
+#include "json_mmap.hpp"
+#include "json_stage1.hpp"
+#include "json_thread_pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Records and line count produced by one chunk
+struct ChunkResult {
+    std::vector<NDJSONRecord> records;
+    size_t lines = 0;
+};
+
+bool isBlank(std::string_view line) {
+    for (char ch : line) {
+        if (!json_detail::isJSONWhitespace(ch)) return false;
+    }
+    return true;
+}
+
+// Parses every line of one chunk; line numbers are relative to the chunk
+void parseChunk(std::string_view chunk, ChunkResult& result) {
+    result.records.clear();
+    result.lines = 0;
+    JSONParser parser;  // Reused for every line; its buffers keep their capacity
+    const char* p = chunk.data();
+    const char* end = p + chunk.size();
+    while (p != end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* lineEnd = newline ? newline : end;
+        std::string_view line(p, static_cast<size_t>(lineEnd - p));
+        result.lines++;
+        p = newline ? newline + 1 : end;
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (isBlank(line)) continue;
+        parser.reset(line);
+
+        NDJSONRecord record;
+        record.line = result.lines;
+        JSONParseResult parsed = parser.tryParse();
+        if (parsed.ok()) record.value = std::move(parsed.value);
+        else record.error = parsed.error.toString();
+        result.records.push_back(std::move(record));
+    }
+}
+
+} // namespace
+
+NDJSONBatchParser::NDJSONBatchParser(size_t threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    pool = std::make_unique<json_detail::WorkStealingPool>(threads);
+}
+
+NDJSONBatchParser::~NDJSONBatchParser() = default;
+
+size_t NDJSONBatchParser::threadCount() const {
+    return pool->size();
+}
+
+std::vector<NDJSONRecord> NDJSONBatchParser::parse(std::string_view input) {
+    std::vector<NDJSONRecord> records;
+    parseChunks(input, SIZE_MAX, [&](std::vector<NDJSONRecord>& chunkRecords) {
+        if (records.empty()) {
+            records = std::move(chunkRecords);
+        } else {
+            records.insert(records.end(), std::make_move_iterator(chunkRecords.begin()),
+                           std::make_move_iterator(chunkRecords.end()));
+        }
+    });
+    return records;
+}
+
+void NDJSONBatchParser::parse(std::string_view input, const std::function<void(NDJSONRecord&)>& callback) {
+    parseChunks(input, pool->size() * 4, [&](std::vector<NDJSONRecord>& chunkRecords) {
+        for (NDJSONRecord& record : chunkRecords) callback(record);
+    });
+}
+
+std::vector<NDJSONRecord> NDJSONBatchParser::parseFile(const std::string& path) {
+    json_detail::MappedFile file(path);
+    return parse(file.view());
+}
+
+void NDJSONBatchParser::parseFile(const std::string& path, const std::function<void(NDJSONRecord&)>& callback) {
+    json_detail::MappedFile file(path);
+    parse(file.view(), callback);
+}
+
+// Splits input into newline-aligned chunks and parses them windowChunks at a time.
+// Each finished window is delivered chunk by chunk in input order, with line
+// numbers rebased onto the whole input.
+void NDJSONBatchParser::parseChunks(std::string_view input, size_t windowChunks,
+                                    const std::function<void(std::vector<NDJSONRecord>&)>& deliver) {
+    std::vector<std::string_view> chunks;
+    size_t position = 0;
+    while (position < input.size()) {
+        size_t end = std::min(input.size(), position + chunkBytes);
+        if (end < input.size()) {
+            const void* newline = std::memchr(input.data() + end, '\n', input.size() - end);
+            end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - input.data()) + 1 : input.size();
+        }
+        chunks.push_back(input.substr(position, end - position));
+        position = end;
+    }
+
+    std::vector<ChunkResult> results(std::min(windowChunks, chunks.size()));
+    size_t lineBase = 0;
+    for (size_t first = 0; first < chunks.size(); first += results.size()) {
+        size_t count = std::min(results.size(), chunks.size() - first);
+        pool->run(count, [&](size_t i) { parseChunk(chunks[first + i], results[i]); });
+
+        for (size_t i = 0; i < count; i++) {
+            for (NDJSONRecord& record : results[i].records) record.line += lineBase;
+            lineBase += results[i].lines;
+            deliver(results[i].records);
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#ifndef JSON_NUMBER_HPP
+#define JSON_NUMBER_HPP
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+// In-place JSON number parsing shared by every parser in the library.
+// Integers that fit are kept exact as int64/uint64; doubles take Clinger's exact
+// fast path when possible and otherwise std::from_chars, which is correctly
+// rounded and ignores the C locale.
+namespace json_detail {
+
+enum class NumberKind { Int64, Uint64, Double };
+
+enum class NumberError {
+    None,
+    ExpectedDigit,
+    ExpectedFractionDigit,
+    ExpectedExponentDigit,
+    OutOfRange
+};
+
+struct ParsedNumber {
+    NumberKind kind = NumberKind::Double;
+    int64_t i = 0;
+    uint64_t u = 0;
+    double d = 0;
+};
+
+inline bool isDigit(char ch) {
+    return static_cast<unsigned char>(ch - '0') < 10;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define JSON_NUMBER_SWAR 0
+#else
+#define JSON_NUMBER_SWAR 1
+#endif
+
+#if JSON_NUMBER_SWAR
+// SWAR helpers: eight ASCII digits loaded as one little-endian word
+inline uint64_t loadEightBytes(const char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline bool isEightDigits(uint64_t value) {
+    return (((value & 0xF0F0F0F0F0F0F0F0ULL) |
+             (((value + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL);
+}
+
+inline uint32_t parseEightDigits(uint64_t value) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+    value -= 0x3030303030303030ULL;
+    value = (value * 10) + (value >> 8);
+    value = (((value & mask) * mul1) + (((value >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(value);
+}
+#endif
+
+// Accumulates a run of digits into mantissa, eight at a time where possible
+inline const char* parseDigits(const char* p, const char* last, uint64_t& mantissa) {
+#if JSON_NUMBER_SWAR
+    while (last - p >= 8) {
+        uint64_t chunk = loadEightBytes(p);
+        if (!isEightDigits(chunk)) break;
+        mantissa = mantissa * 100000000 + parseEightDigits(chunk);
+        p += 8;
+    }
+#endif
+    while (p != last && isDigit(*p)) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        p++;
+    }
+    return p;
+}
+
+// Slow path for long mantissas and large exponents
+inline NumberError parseDoubleFallback(const char* first, const char* last, double& out) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(first, last, out);
+    if (result.ec == std::errc::result_out_of_range) return NumberError::OutOfRange;
+    return result.ec == std::errc() ? NumberError::None : NumberError::ExpectedDigit;
+#else
+    std::string text(first, last);
+    char* end = nullptr;
+    errno = 0;
+    out = std::strtod(text.c_str(), &end);
+    if (errno == ERANGE) return NumberError::OutOfRange;
+    return end == text.c_str() + text.size() ? NumberError::None : NumberError::ExpectedDigit;
+#endif
+}
+
+// Parses the JSON number grammar starting at first. On success end points just
+// past the number; on failure it points at the offending character.
+inline NumberError parseNumber(const char* first, const char* last, ParsedNumber& out, const char*& end) {
+    static const double exactPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* p = first;
+    bool negative = p != last && *p == '-';
+    if (negative) p++;
+
+    end = p;
+    if (p == last || !isDigit(*p)) return NumberError::ExpectedDigit;
+
+    uint64_t mantissa = 0;
+    const char* digitsStart = p;
+    p = parseDigits(p, last, mantissa);
+    size_t integerDigits = static_cast<size_t>(p - digitsStart);
+
+    size_t fractionDigits = 0;
+    if (p != last && *p == '.') {
+        p++;
+        const char* fractionStart = p;
+        if (p == last || !isDigit(*p)) {
+            end = p;
+            return NumberError::ExpectedFractionDigit;
+        }
+        p = parseDigits(p, last, mantissa);
+        fractionDigits = static_cast<size_t>(p - fractionStart);
+    }
+
+    bool hasExponent = false;
+    int64_t exponent = 0;
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        hasExponent = true;
+        p++;
+        bool negativeExponent = false;
+        if (p != last && (*p == '+' || *p == '-')) {
+            negativeExponent = *p == '-';
+            p++;
+        }
+        if (p == last || !isDigit(*p)) {
+            end = p;
+            return NumberError::ExpectedExponentDigit;
+        }
+        while (p != last && isDigit(*p)) {
+            if (exponent < 100000) exponent = exponent * 10 + (*p - '0');
+            p++;
+        }
+        if (negativeExponent) exponent = -exponent;
+    }
+    end = p;
+
+    // Integer fast path: exact int64/uint64 when the value fits
+    size_t totalDigits = integerDigits + fractionDigits;
+    if (fractionDigits == 0 && !hasExponent) {
+        if (integerDigits <= 19) {
+            if (negative) {
+                if (mantissa == 0) {
+                    out.kind = NumberKind::Double;  // keep the sign of -0
+                    out.d = -0.0;
+                    return NumberError::None;
+                }
+                if (mantissa <= uint64_t(INT64_MAX) + 1) {
+                    out.kind = NumberKind::Int64;
+                    out.i = static_cast<int64_t>(0 - mantissa);
+                    return NumberError::None;
+                }
+            } else if (mantissa <= uint64_t(INT64_MAX)) {
+                out.kind = NumberKind::Int64;
+                out.i = static_cast<int64_t>(mantissa);
+                return NumberError::None;
+            } else {
+                out.kind = NumberKind::Uint64;
+                out.u = mantissa;
+                return NumberError::None;
+            }
+        } else if (integerDigits == 20 && !negative) {
+            uint64_t value = 0;
+            auto result = std::from_chars(digitsStart, p, value);
+            if (result.ec == std::errc()) {
+                out.kind = NumberKind::Uint64;
+                out.u = value;
+                return NumberError::None;
+            }
+        }
+    }
+
+    // Clinger's fast path: mantissa and power of ten are both exact doubles,
+    // so one IEEE multiply or divide is correctly rounded
+    out.kind = NumberKind::Double;
+    int64_t decimalExponent = exponent - static_cast<int64_t>(fractionDigits);
+    if (totalDigits <= 19 && mantissa <= (uint64_t(1) << 53) &&
+        decimalExponent >= -22 && decimalExponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = decimalExponent < 0 ? value / exactPowersOfTen[-decimalExponent]
+                                    : value * exactPowersOfTen[decimalExponent];
+        out.d = negative ? -value : value;
+        return NumberError::None;
+    }
+
+    return parseDoubleFallback(first, p, out.d);
+}
+
+// The exact value of a JSONValue or JSONLazyValue number
+template <typename Value>
+ParsedNumber exactNumber(const Value& value) {
+    ParsedNumber number;
+    if (!value.isInteger()) {
+        number.d = value.asNumber();
+    } else if (value.asNumber() < 0) {
+        number.kind = NumberKind::Int64;
+        number.i = value.asInt64();
+    } else {
+        number.kind = NumberKind::Uint64;
+        number.u = value.asUint64();
+    }
+    return number;
+}
+
+// Orders an integer against a double by the double's exact value, so that
+// 2^53 + 1 is not equal to the double 2^53 it would round to
+inline int compareIntegerToDouble(const ParsedNumber& integer, double d) {
+    if (d >= 18446744073709551616.0) return -1;   // 2^64 and up, including +inf
+    if (d < -9223372036854775808.0) return 1;     // Below -2^63, including -inf
+    double whole = std::trunc(d);
+    int order;
+    if (integer.kind == NumberKind::Int64) {
+        if (whole >= 9223372036854775808.0) return -1;
+        int64_t w = static_cast<int64_t>(whole);
+        order = integer.i < w ? -1 : (integer.i > w ? 1 : 0);
+    } else {
+        if (d < 0) return 1;
+        uint64_t w = static_cast<uint64_t>(whole);
+        order = integer.u < w ? -1 : (integer.u > w ? 1 : 0);
+    }
+    if (order != 0) return order;
+    return d > whole ? -1 : (d < whole ? 1 : 0);  // Equal whole parts: the fraction decides
+}
+
+// Orders two numbers exactly: -1, 0 or 1. Integers are compared as integers,
+// and only two doubles are compared as doubles.
+inline int compareNumbers(const ParsedNumber& a, const ParsedNumber& b) {
+    bool aInteger = a.kind != NumberKind::Double;
+    bool bInteger = b.kind != NumberKind::Double;
+    if (aInteger && bInteger) {
+        if (a.kind == NumberKind::Int64 && b.kind == NumberKind::Int64) return a.i < b.i ? -1 : (a.i > b.i ? 1 : 0);
+        if (a.kind == NumberKind::Int64 && a.i < 0) return -1;
+        if (b.kind == NumberKind::Int64 && b.i < 0) return 1;
+        uint64_t x = a.kind == NumberKind::Int64 ? static_cast<uint64_t>(a.i) : a.u;
+        uint64_t y = b.kind == NumberKind::Int64 ? static_cast<uint64_t>(b.i) : b.u;
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+    if (aInteger) return compareIntegerToDouble(a, b.d);
+    if (bInteger) return -compareIntegerToDouble(b, a.d);
+    return a.d < b.d ? -1 : (a.d > b.d ? 1 : 0);
+}
+
+} // namespace json_detail
+
+#endif
@@ -1,68 +1,177 @@
 #include "json_parser.hpp"
-#include <cctype>
+#include "json_mmap.hpp"
+#include "json_number.hpp"
+#include "json_stage1.hpp"
+#include "json_stats.hpp"
+#include "json_string.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
 #include <stdexcept>
 
-// Constructor
-JSONParser::JSONParser(const std::string& jsonString) : json(jsonString), index(0) {}
+// Constructors that copy the input into parser-owned storage
+JSONParser::JSONParser(const std::string& jsonString) : JSONParser(std::string(jsonString)) {}
+
+JSONParser::JSONParser(std::string&& jsonString) : index(0) {
+    auto owned = std::make_shared<const std::string>(std::move(jsonString));
+    json = *owned;
+    storage = std::move(owned);
+}
+
+JSONParser::JSONParser(const char* jsonString) : JSONParser(std::string(jsonString)) {}
+
+// Zero-copy constructors that parse the caller's buffer in place
+JSONParser::JSONParser(std::string_view jsonView) : json(jsonView), index(0) {}
+
+JSONParser::JSONParser(const char* data, size_t length) : json(data, length), index(0) {}
+
+// Re-points the parser at new input, keeping its buffers
+void JSONParser::reset(std::string_view jsonView) {
+    storage.reset();
+    json = jsonView;
+    index = 0;
+}
+
+// Maps a file read-only and parses it without copying
+JSONParser JSONParser::fromFile(const std::string& path) {
+    auto mapped = std::make_shared<const json_detail::MappedFile>(path);
+    JSONParser parser(mapped->view());
+    parser.storage = std::move(mapped);
+    return parser;
+}
 
 // Checks if we've reached the end of input
 bool JSONParser::isEnd() const {
     return index >= json.length();
 }
 
-// Peeks at the current character
+// Peeks at the current character; '\0' at the end, which no check accepts
 char JSONParser::peek() const {
-    if (isEnd()) throw std::runtime_error("Unexpected end of input");
-    return json[index];
+    return isEnd() ? '\0' : json[index];
 }
 
-// Advances to the next character
-char JSONParser::advance() {
-    if (isEnd()) throw std::runtime_error("Unexpected end of input");
-    return json[index++];
+// Steps past a character the caller has already checked
+void JSONParser::advance() {
+    index++;
 }
 
-// Skips whitespace characters
+// Skips whitespace by jumping to the next token offset recorded by stage 1
 void JSONParser::skipWhitespace() {
-    while (!isEnd() && std::isspace(peek())) advance();
+    if (!indexed) {
+        while (!isEnd() && json_detail::isJSONWhitespace(json[index])) index++;
+        return;
+    }
+    
+    while (nextStructural < structurals.size() && structurals[nextStructural] < index) nextStructural++;
+    size_t target = nextStructural < structurals.size() ? structurals[nextStructural] : json.length();
+    
+    // Only whitespace may sit between tokens. Anything else glued to the end of a
+    // number or literal (e.g. "12x", "truex") is left in place, where it fails the
+    // caller's check for a separator or the end of input.
+    if (index < target && !json_detail::isJSONWhitespace(json[index])) return;
+    index = target;
+}
+
+// Records the first failure at the current position
+bool JSONParser::fail(JSONErrorCode code) {
+    error.code = code;
+    error.offset = index;
+    return false;
+}
+
+// A missing separator at the end of input is reported as a truncated document
+bool JSONParser::failExpected(JSONErrorCode code) {
+    return fail(isEnd() ? JSONErrorCode::UnexpectedEnd : code);
+}
+
+// Times one parse phase when statistics are enabled. Time spent in phases nested
+// inside it is passed up and subtracted, so each counter is exclusive.
+class JSONParser::PhaseTimer {
+    public:
+        PhaseTimer(JSONParser& parser, uint64_t& counter) : parser(parser), counter(counter) {
+            if constexpr (statsEnabled) {
+                outerNested = parser.nestedCycles;
+                parser.nestedCycles = 0;
+                start = json_detail::readCycles();
+            }
+        }
+
+        ~PhaseTimer() {
+            if constexpr (statsEnabled) {
+                uint64_t elapsed = json_detail::readCycles() - start;
+                counter += elapsed - std::min(elapsed, parser.nestedCycles);
+                parser.nestedCycles = outerNested + elapsed;
+            }
+        }
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        JSONParser& parser;
+        uint64_t& counter;
+        uint64_t start = 0;
+        uint64_t outerNested = 0;
+};
+
+// Closes an object or array that started at input offset start
+bool JSONParser::leaveContainer(uint64_t& count, uint64_t& bytes, size_t start) {
+    depth--;
+    if constexpr (statsEnabled) {
+        count++;
+        bytes += index - start;
+    }
+    return true;
 }
 
 // Parses a generic JSON value
-JSONValue JSONParser::parseValue() {
+bool JSONParser::parseValue(JSONValue& out) {
     skipWhitespace();
-    if (isEnd()) throw std::runtime_error("Unexpected end of input");
+    if (isEnd()) return fail(JSONErrorCode::UnexpectedEnd);
     
     char ch = peek();
-    if (ch == '{') return parseObject();
-    if (ch == '[') return parseArray();
-    if (ch == '"') return parseString();
-    if (std::isdigit(ch) || ch == '-') return parseNumber();
-    if (ch == 't' || ch == 'f' || ch == 'n') return parseBoolOrNull();
+    if (ch == '{') return parseObject(out);
+    if (ch == '[') return parseArray(out);
+    if (ch == '"') return parseString(out);
+    if (json_detail::isDigit(ch) || ch == '-') return parseNumber(out);
+    if (ch == 't' || ch == 'f' || ch == 'n') return parseBoolOrNull(out);
     
-    throw std::runtime_error("Invalid JSON value");
+    return fail(JSONErrorCode::InvalidValue);
 }
 
-// Parses a JSON object { "key": value }
-JSONValue JSONParser::parseObject() {
-    JSONValue::Object obj;
+// Parses a JSON object { "key": value }. Members collect on a shared stack until
+// the closing brace, then move into an object allocated at its exact size.
+bool JSONParser::parseObject(JSONValue& out) {
+    PhaseTimer timer(*this, stats.objectCycles);
+    size_t start = index;
+    if (++depth > maxDepth) return fail(JSONErrorCode::DepthLimitExceeded);
+    if constexpr (statsEnabled) stats.maxDepth = std::max<uint64_t>(stats.maxDepth, depth);
     advance(); // Consume '{'
     skipWhitespace();
     
     if (peek() == '}') {
         advance(); // Empty object
-        return obj;
+        out = JSONValue::Object(resource);
+        return leaveContainer(stats.objects, stats.objectBytes, start);
     }
     
+    size_t firstMember = pendingMembers.size();
+    size_t firstEscapedByte = escapedKeys.size();
     while (true) {
-        if (peek() != '"') throw std::runtime_error("Expected string key in object");
+        if (peek() != '"') return failExpected(JSONErrorCode::ExpectedKey);
         
-        JSONValue key = parseString();
+        PendingMember member{0, 0, false, JSONValue()};
+        if (!parseKey(member)) return false;
         skipWhitespace();
         
-        if (advance() != ':') throw std::runtime_error("Expected ':' after key");
+        if (peek() != ':') return failExpected(JSONErrorCode::ExpectedColon);
+        advance(); // Consume ':'
         skipWhitespace();
         
-        obj[key.asString()] = parseValue();
+        if (!parseValue(member.value)) return false;
+        pendingMembers.push_back(std::move(member));
         skipWhitespace();
         
         if (peek() == '}') {
@@ -70,27 +179,67 @@ JSONValue JSONParser::parseObject() {
             break;
         }
         
-        if (peek() != ',') throw std::runtime_error("Expected ',' or '}' after value in object");
+        if (peek() != ',') return failExpected(JSONErrorCode::ExpectedCommaOrBrace);
         advance(); // Consume ','
         skipWhitespace();
     }
     
-    return obj;
+    size_t memberCount = pendingMembers.size() - firstMember;
+    JSONValue::Object obj(resource);
+    obj.reserve(memberCount);
+    std::string_view escaped = escapedKeys;
+    for (size_t i = firstMember; i < pendingMembers.size(); i++) {
+        PendingMember& member = pendingMembers[i];
+        std::string_view key = (member.escaped ? escaped : json).substr(member.keyOffset, member.keyLength);
+        if (keyTable) {
+            obj.insert_or_assign(keyTable->intern(key), std::move(member.value));
+        } else {
+            obj.insert_or_assign(key, std::move(member.value));
+            if constexpr (statsEnabled) {
+                if (key.size() > JSONKey::inlineCapacity) {
+                    stats.allocations++;
+                    stats.allocatedBytes += key.size();
+                }
+            }
+        }
+    }
+    pendingMembers.erase(pendingMembers.begin() + static_cast<std::ptrdiff_t>(firstMember), pendingMembers.end());
+    escapedKeys.resize(firstEscapedByte);
+    if constexpr (statsEnabled) {
+        stats.allocations += obj.indexBytes() ? 2 : 1;
+        stats.allocatedBytes += memberCount * sizeof(JSONValue::Object::value_type) + obj.indexBytes();
+    }
+    
+    out = std::move(obj);
+    return leaveContainer(stats.objects, stats.objectBytes, start);
 }
 
 // Parses a JSON array [value1, value2, ...]
-JSONValue JSONParser::parseArray() {
-    JSONValue::Array arr;
+bool JSONParser::parseArray(JSONValue& out) {
+    PhaseTimer timer(*this, stats.arrayCycles);
+    size_t start = index;
+    if (++depth > maxDepth) return fail(JSONErrorCode::DepthLimitExceeded);
+    if constexpr (statsEnabled) stats.maxDepth = std::max<uint64_t>(stats.maxDepth, depth);
+    JSONValue::Array arr(resource);
     advance(); // Consume '['
     skipWhitespace();
     
     if (peek() == ']') {
         advance(); // Empty array
-        return arr;
+        out = std::move(arr);
+        return leaveContainer(stats.arrays, stats.arrayBytes, start);
     }
     
     while (true) {
-        arr.push_back(parseValue());
+        size_t capacity = arr.capacity();
+        JSONValue& element = arr.emplace_back();
+        if constexpr (statsEnabled) {
+            if (arr.capacity() != capacity) {
+                stats.allocations++;
+                stats.allocatedBytes += arr.capacity() * sizeof(JSONValue);
+            }
+        }
+        if (!parseValue(element)) return false;
         skipWhitespace();
         
         if (peek() == ']') {
@@ -98,117 +247,710 @@ JSONValue JSONParser::parseArray() {
             break;
         }
         
-        if (peek() != ',') throw std::runtime_error("Expected ',' or ']' after value in array");
+        if (peek() != ',') return failExpected(JSONErrorCode::ExpectedCommaOrBracket);
         advance(); // Consume ','
         skipWhitespace();
     }
     
-    return arr;
+    out = std::move(arr);
+    return leaveContainer(stats.arrays, stats.arrayBytes, start);
 }
 
-// Parses a JSON string
-JSONValue JSONParser::parseString() {
-    advance(); // Consume '"'
-    std::string str;
-    
-    while (!isEnd() && peek() != '"') {
-        char ch = advance();
-        
-        if (ch == '\\') {
-            if (isEnd()) throw std::runtime_error("Unterminated escape sequence");
-            
-            ch = advance();
-            switch (ch) {
-                case '"': case '\\': case '/':
-                    str += ch;
-                    break;
-                case 'b': str += '\b'; break;
-                case 'f': str += '\f'; break;
-                case 'n': str += '\n'; break;
-                case 'r': str += '\r'; break;
-                case 't': str += '\t'; break;
-                default:
-                    throw std::runtime_error("Invalid escape sequence");
-            }
-        } else {
-            str += ch;
+// Parses a JSON string value
+bool JSONParser::parseString(JSONValue& out) {
+    PhaseTimer timer(*this, stats.stringCycles);
+    size_t start = index;
+    JSONValue::String str(resource);
+    if (!parseRawString(str)) return false;
+    if constexpr (statsEnabled) {
+        static const size_t inlineCapacity = JSONValue::String().capacity();
+        stats.strings++;
+        stats.stringBytes += index - start;
+        if (str.capacity() > inlineCapacity) {
+            stats.allocations++;
+            stats.allocatedBytes += str.capacity() + 1;
         }
     }
+    out = std::move(str);
+    return true;
+}
+
+namespace {
+
+JSONErrorCode stringErrorCode(json_detail::StringError error) {
+    switch (error) {
+        case json_detail::StringError::None: break;
+        case json_detail::StringError::InvalidEscape: return JSONErrorCode::InvalidEscape;
+        case json_detail::StringError::InvalidUnicodeEscape: return JSONErrorCode::InvalidUnicodeEscape;
+        case json_detail::StringError::UnterminatedEscape: return JSONErrorCode::UnterminatedEscape;
+        case json_detail::StringError::Unterminated: return JSONErrorCode::UnterminatedString;
+        case json_detail::StringError::ControlCharacter: return JSONErrorCode::ControlCharacter;
+        case json_detail::StringError::InvalidUTF8: return JSONErrorCode::InvalidUTF8;
+    }
+    return JSONErrorCode::None;
+}
+
+JSONErrorCode numberErrorCode(json_detail::NumberError error) {
+    switch (error) {
+        case json_detail::NumberError::None: break;
+        case json_detail::NumberError::ExpectedDigit: return JSONErrorCode::ExpectedDigit;
+        case json_detail::NumberError::ExpectedFractionDigit: return JSONErrorCode::ExpectedFractionDigit;
+        case json_detail::NumberError::ExpectedExponentDigit: return JSONErrorCode::ExpectedExponentDigit;
+        case json_detail::NumberError::OutOfRange: return JSONErrorCode::NumberOutOfRange;
+    }
+    return JSONErrorCode::None;
+}
+
+} // namespace
+
+// Parses a JSON string into out, which allocates from the parser's resource
+bool JSONParser::parseRawString(JSONValue::String& out) {
+    advance(); // Consume '"'
     
-    if (isEnd()) throw std::runtime_error("Unterminated string");
-    advance(); // Consume closing '"'
+    const char* first = json.data() + index;
+    const char* end = nullptr;
+    json_detail::StringError status = json_detail::decodeString(first, json.data() + json.length(), out, end);
+    index += static_cast<size_t>(end - first);
     
-    return str;
+    if (status != json_detail::StringError::None) return fail(stringErrorCode(status));
+    advance(); // Consume closing '"'
+    return true;
 }
 
-// Parses a JSON number
-JSONValue JSONParser::parseNumber() {
-    std::string numStr;
-    
-    // Handle negative numbers
-    if (peek() == '-') {
-        numStr += advance();
+// Records where a key's text is: in the input when it has no escapes, otherwise
+// decoded onto the end of escapedKeys, which keeps it until its object is built
+bool JSONParser::parseKey(PendingMember& member) {
+    if constexpr (statsEnabled) {
+        size_t start = index;
+        bool parsed = parseKeyText(member);
+        stats.keys++;
+        stats.keyBytes += index - start;
+        return parsed;
     }
-    
-    // Integer part
-    if (!std::isdigit(peek())) throw std::runtime_error("Expected digit");
-    while (!isEnd() && std::isdigit(peek())) {
-        numStr += advance();
+    return parseKeyText(member);
+}
+
+bool JSONParser::parseKeyText(PendingMember& member) {
+    const char* first = json.data() + index + 1;
+    const char* last = json.data() + json.length();
+    const char* special = nullptr;
+    json_detail::StringError status = json_detail::scanString(first, last, special);
+    if (status != json_detail::StringError::None) {
+        index = static_cast<size_t>(special - json.data());
+        return fail(stringErrorCode(status));
     }
-    
-    // Fractional part
-    if (!isEnd() && peek() == '.') {
-        numStr += advance();
-        if (!std::isdigit(peek())) throw std::runtime_error("Expected digit after decimal point");
-        while (!isEnd() && std::isdigit(peek())) {
-            numStr += advance();
-        }
+    if (*special == '"') {
+        member.keyOffset = index + 1;
+        member.keyLength = static_cast<size_t>(special - first);
+        if (member.keyLength > UINT32_MAX) return fail(JSONErrorCode::KeyTooLong);
+        index = static_cast<size_t>(special - json.data()) + 1;
+        return true;
     }
     
-    // Exponent part
-    if (!isEnd() && (peek() == 'e' || peek() == 'E')) {
-        numStr += advance();
-        if (!isEnd() && (peek() == '+' || peek() == '-')) {
-            numStr += advance();
-        }
-        if (!isEnd() && !std::isdigit(peek())) throw std::runtime_error("Expected digit in exponent");
-        while (!isEnd() && std::isdigit(peek())) {
-            numStr += advance();
-        }
+    advance(); // Consume '"'
+    member.escaped = true;
+    member.keyOffset = escapedKeys.size();
+    const char* end = nullptr;
+    status = json_detail::decodeString(first, last, escapedKeys, end);
+    index += static_cast<size_t>(end - first);
+    
+    if (status != json_detail::StringError::None) return fail(stringErrorCode(status));
+    member.keyLength = escapedKeys.size() - member.keyOffset;
+    if (member.keyLength > UINT32_MAX) return fail(JSONErrorCode::KeyTooLong);
+    advance(); // Consume closing '"'
+    return true;
+}
+
+// Parses a JSON number in place, keeping integers exact
+bool JSONParser::parseNumber(JSONValue& out) {
+    PhaseTimer timer(*this, stats.numberCycles);
+    json_detail::ParsedNumber number;
+    const char* end = nullptr;
+    const char* first = json.data() + index;
+    json_detail::NumberError status = json_detail::parseNumber(first, json.data() + json.length(), number, end);
+    index += static_cast<size_t>(end - first);
+    
+    if (status != json_detail::NumberError::None) return fail(numberErrorCode(status));
+    if constexpr (statsEnabled) {
+        stats.numbers++;
+        stats.numberBytes += static_cast<size_t>(end - first);
     }
     
-    return std::stod(numStr);
+    switch (number.kind) {
+        case json_detail::NumberKind::Int64: out = number.i; break;
+        case json_detail::NumberKind::Uint64: out = number.u; break;
+        case json_detail::NumberKind::Double: out = number.d; break;
+    }
+    return true;
 }
 
 // Parses true, false, or null
-JSONValue JSONParser::parseBoolOrNull() {
+bool JSONParser::parseBoolOrNull(JSONValue& out) {
+    size_t length = 0;
     if (json.length() - index >= 4 && json.substr(index, 4) == "true") {
-        index += 4;
-        return true;
-    }
-    if (json.length() - index >= 5 && json.substr(index, 5) == "false") {
-        index += 5;
-        return false;
-    }
-    if (json.length() - index >= 4 && json.substr(index, 4) == "null") {
-        index += 4;
-        return nullptr;
+        length = 4;
+        out = true;
+    } else if (json.length() - index >= 5 && json.substr(index, 5) == "false") {
+        length = 5;
+        out = false;
+    } else if (json.length() - index >= 4 && json.substr(index, 4) == "null") {
+        length = 4;
+        out = nullptr;
+    } else {
+        return fail(JSONErrorCode::InvalidKeyword);
     }
     
-    throw std::runtime_error("Invalid JSON keyword");
+    index += length;
+    if constexpr (statsEnabled) {
+        stats.literals++;
+        stats.literalBytes += length;
+    }
+    return true;
 }
 
-// Starts parsing from the beginning
-JSONValue JSONParser::parse() {
+// Starts parsing from the beginning, interning object keys in keys when it is set
+bool JSONParser::parseDocument(JSONValue& out, std::pmr::memory_resource* memory, JSONKeyTable* keys) {
+    resource = memory;
+    keyTable = keys;
+    error = JSONError();
+    pendingMembers.clear();
+    escapedKeys.clear();
     index = 0;
+    depth = 0;
+    nextStructural = 0;
+    indexed = json.length() <= json_detail::maxStructuralInput;
+    if (indexed) {
+        uint64_t started = statsEnabled ? json_detail::readCycles() : 0;
+        json_detail::findStructurals(json.data(), json.length(), structurals);
+        if constexpr (statsEnabled) stats.stage1Cycles = json_detail::readCycles() - started;
+    }
     skipWhitespace();
-    JSONValue result = parseValue();
+    if (!parseValue(out)) return false;
     skipWhitespace();
     
-    if (!isEnd()) {
-        throw std::runtime_error("Unexpected data after JSON value");
+    if (!isEnd()) return fail(JSONErrorCode::TrailingData);
+    return true;
+}
+
+JSONValue JSONParser::parse() {
+    return parse(std::pmr::get_default_resource());
+}
+
+JSONValue JSONParser::parse(std::pmr::memory_resource* memory) {
+    return parse(memory, nullptr);
+}
+
+// Throwing wrapper over tryParse
+JSONValue JSONParser::parse(std::pmr::memory_resource* memory, JSONKeyTable* keys) {
+    JSONParseResult result = tryParse(memory, keys);
+    if (result.error.code == JSONErrorCode::OutOfMemory) throw std::bad_alloc();
+    if (result.error) throw std::runtime_error(result.error.toString());
+    return std::move(result.value);
+}
+
+JSONParseResult JSONParser::tryParse() noexcept {
+    return tryParse(std::pmr::get_default_resource());
+}
+
+JSONParseResult JSONParser::tryParse(std::pmr::memory_resource* memory) noexcept {
+    return tryParse(memory, nullptr);
+}
+
+// Allocation is the only thing left that can throw, so the handler here is the
+// single catch site and costs nothing unless memory runs out
+JSONParseResult JSONParser::tryParse(std::pmr::memory_resource* memory, JSONKeyTable* keys) noexcept {
+    JSONParseResult result;
+    bool parsed = false;
+    uint64_t started = 0;
+    if constexpr (statsEnabled) {
+        stats = JSONParseStats();
+        nestedCycles = 0;
+        started = json_detail::readCycles();
+    }
+    try {
+        parsed = parseDocument(result.value, memory, keys);
+    } catch (const std::bad_alloc&) {
+        fail(JSONErrorCode::OutOfMemory);
+    } catch (const std::length_error&) {
+        fail(JSONErrorCode::OutOfMemory);
     }
+    if constexpr (statsEnabled) finishStats(parsed, started);
+    if (parsed) return result;
     
+    // A partial tree, and the members of any object left unfinished, may hold memory
+    // from resource. They are dropped before returning, while it is still alive.
+    result.value = JSONValue();
+    pendingMembers.clear();
+    escapedKeys.clear();
+    result.error = error;
+    std::string_view before = json.substr(0, std::min(error.offset, json.length()));
+    size_t lastNewline = before.rfind('\n');
+    result.error.line = static_cast<size_t>(std::count(before.begin(), before.end(), '\n')) + 1;
+    result.error.column = lastNewline == std::string_view::npos ? before.size() + 1 : before.size() - lastNewline;
     return result;
 }
 
+// Completes the document's statistics and adds them to this thread's totals
+void JSONParser::finishStats(bool parsed, uint64_t started) {
+    stats.totalCycles = json_detail::readCycles() - started;
+    stats.documents = 1;
+    stats.failedDocuments = parsed ? 0 : 1;
+    stats.inputBytes = json.length();
+    try {
+        json_detail::recordStats(stats);
+    } catch (const std::bad_alloc&) {
+        // Registering a new thread's counters can fail; its statistics are then dropped
+    }
+}
+
+JSONParseStats JSONParser::totalStats() {
+    return json_detail::collectStats();
+}
+
+void JSONParser::resetTotalStats() {
+    json_detail::resetStats();
+}
+
+const char* jsonErrorMessage(JSONErrorCode code) noexcept {
+    switch (code) {
+        case JSONErrorCode::None: return "No error";
+        case JSONErrorCode::UnexpectedEnd: return "Unexpected end of input";
+        case JSONErrorCode::InvalidValue: return "Invalid JSON value";
+        case JSONErrorCode::ExpectedKey: return "Expected string key in object";
+        case JSONErrorCode::ExpectedColon: return "Expected ':' after key";
+        case JSONErrorCode::ExpectedCommaOrBrace: return "Expected ',' or '}' after value in object";
+        case JSONErrorCode::ExpectedCommaOrBracket: return "Expected ',' or ']' after value in array";
+        case JSONErrorCode::InvalidEscape: return "Invalid escape sequence";
+        case JSONErrorCode::InvalidUnicodeEscape: return "Invalid \\u escape";
+        case JSONErrorCode::UnterminatedEscape: return "Unterminated escape sequence";
+        case JSONErrorCode::UnterminatedString: return "Unterminated string";
+        case JSONErrorCode::ControlCharacter: return "Unescaped control character in string";
+        case JSONErrorCode::InvalidUTF8: return "Invalid UTF-8 in string";
+        case JSONErrorCode::ExpectedDigit: return "Expected digit";
+        case JSONErrorCode::ExpectedFractionDigit: return "Expected digit after decimal point";
+        case JSONErrorCode::ExpectedExponentDigit: return "Expected digit in exponent";
+        case JSONErrorCode::NumberOutOfRange: return "Number out of range";
+        case JSONErrorCode::InvalidKeyword: return "Invalid JSON keyword";
+        case JSONErrorCode::TrailingData: return "Unexpected data after JSON value";
+        case JSONErrorCode::KeyTooLong: return "Object key too long";
+        case JSONErrorCode::DepthLimitExceeded: return "Maximum nesting depth exceeded";
+        case JSONErrorCode::OutOfMemory: return "Out of memory";
+    }
+    return "Unknown error";
+}
+
+std::string JSONError::toString() const {
+    return std::string(message()) + " at line " + std::to_string(line) + ", column " + std::to_string(column);
+}
+
+
+// Objects start without an index; it is built once they outgrow linear search
+JSONObject::JSONObject() : JSONObject(std::pmr::get_default_resource()) {}
+
+JSONObject::JSONObject(std::pmr::memory_resource* resource) : members(resource) {}
+
+JSONObject::JSONObject(const JSONObject& other) : JSONObject() {
+    copyFrom(other);
+}
+
+JSONObject::JSONObject(JSONObject&& other) noexcept
+    : members(std::move(other.members)), index(other.index), indexMask(other.indexMask) {
+    other.index = nullptr;
+    other.indexMask = 0;
+}
+
+JSONObject& JSONObject::operator=(const JSONObject& other) {
+    if (this != &other) {
+        clear();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+// Steals the members when both objects allocate from the same resource, copies otherwise
+JSONObject& JSONObject::operator=(JSONObject&& other) {
+    if (this == &other) return *this;
+    if (resource() != other.resource()) return *this = static_cast<const JSONObject&>(other);
+
+    clear();
+    members = std::move(other.members);
+    index = other.index;
+    indexMask = other.indexMask;
+    other.index = nullptr;
+    other.indexMask = 0;
+    return *this;
+}
+
+JSONObject::~JSONObject() {
+    for (const value_type& member : members) freeKey(member.first);
+    releaseIndex();
+}
+
+// Short keys are compared as zero-padded 16-byte blocks; wide objects go through the index
+size_t JSONObject::findPosition(std::string_view key) const {
+    if (indexMask == 0) {
+        if (key.size() <= JSONKey::inlineCapacity) {
+            char probe[JSONKey::inlineCapacity] = {};
+            std::memcpy(probe, key.data(), key.size());
+            for (size_t i = 0; i < members.size(); i++) {
+                const JSONKey& candidate = members[i].first;
+                if (candidate.length == key.size() && std::memcmp(candidate.small, probe, sizeof(probe)) == 0) {
+                    return i;
+                }
+            }
+            return members.size();
+        }
+        for (size_t i = 0; i < members.size(); i++) {
+            if (members[i].first.view() == key) return i;
+        }
+        return members.size();
+    }
+
+    for (size_t slot = std::hash<std::string_view>()(key) & indexMask; index[slot] != 0; slot = (slot + 1) & indexMask) {
+        size_t position = index[slot] - 1;
+        if (members[position].first.view() == key) return position;
+    }
+    return members.size();
+}
+
+JSONValue& JSONObject::at(std::string_view key) {
+    size_t position = findPosition(key);
+    if (position == members.size()) throw std::out_of_range("JSONObject::at: key not found");
+    return members[position].second;
+}
+
+const JSONValue& JSONObject::at(std::string_view key) const {
+    size_t position = findPosition(key);
+    if (position == members.size()) throw std::out_of_range("JSONObject::at: key not found");
+    return members[position].second;
+}
+
+JSONValue& JSONObject::operator[](std::string_view key) {
+    size_t position = findPosition(key);
+    if (position != members.size()) return members[position].second;
+    return append(copyKey(key), JSONValue())->second;
+}
+
+std::pair<JSONObject::iterator, bool> JSONObject::insert_or_assign(std::string_view key, JSONValue value) {
+    size_t position = findPosition(key);
+    if (position != members.size()) {
+        members[position].second = std::move(value);
+        return {begin() + position, false};
+    }
+    return {append(copyKey(key), std::move(value)), true};
+}
+
+std::pair<JSONObject::iterator, bool> JSONObject::insert_or_assign(const JSONKey& key, JSONValue value) {
+    size_t position = findPosition(key.view());
+    if (position != members.size()) {
+        members[position].second = std::move(value);
+        return {begin() + position, false};
+    }
+    return {append(key.interned ? key : copyKey(key.view()), std::move(value)), true};
+}
+
+// Removing a member keeps the others in order. The index is fixed up in place
+// rather than rebuilt, so erase costs one shift of the members after it.
+size_t JSONObject::erase(std::string_view key) {
+    size_t position = findPosition(key);
+    if (position == members.size()) return 0;
+    if (indexMask != 0) {
+        if (members.size() - 1 > linearLimit) unindex(position);
+        else releaseIndex();
+    }
+    freeKey(members[position].first);
+    members.erase(members.begin() + static_cast<std::ptrdiff_t>(position));
+    return 1;
+}
+
+// Drops the member at position from the index while it is still in members.
+// Later entries of its probe run move back into the hole (backward-shift
+// deletion), and the positions of the members after it go down by one.
+void JSONObject::unindex(size_t position) {
+    auto home = [this](size_t slot) {
+        return std::hash<std::string_view>()(members[index[slot] - 1].first.view()) & indexMask;
+    };
+    size_t hole = std::hash<std::string_view>()(members[position].first.view()) & indexMask;
+    while (index[hole] != position + 1) hole = (hole + 1) & indexMask;
+
+    for (size_t next = (hole + 1) & indexMask; index[next] != 0; next = (next + 1) & indexMask) {
+        // An entry may fill the hole unless its home slot lies after the hole in the run
+        if (((next - home(next)) & indexMask) >= ((next - hole) & indexMask)) {
+            index[hole] = index[next];
+            hole = next;
+        }
+    }
+    index[hole] = 0;
+
+    for (size_t slot = 0; slot <= indexMask; slot++) {
+        if (index[slot] > position + 1) index[slot]--;
+    }
+}
+
+void JSONObject::clear() {
+    for (const value_type& member : members) freeKey(member.first);
+    members.clear();
+    releaseIndex();
+}
+
+// Also sizes the index up front when the object will outgrow linear search
+void JSONObject::reserve(size_t count) {
+    members.reserve(count);
+    if (count > linearLimit && count * 2 > static_cast<size_t>(indexMask) + 1) buildIndex(count * 2);
+}
+
+// Short keys live in the key; longer ones are copied into the object's resource
+JSONKey JSONObject::copyKey(std::string_view text) {
+    if (text.size() > UINT32_MAX) throw std::runtime_error("Object key too long");
+    JSONKey key;
+    key.length = static_cast<uint32_t>(text.size());
+    if (text.size() <= JSONKey::inlineCapacity) {
+        std::memcpy(key.small, text.data(), text.size());
+    } else {
+        char* bytes = static_cast<char*>(resource()->allocate(text.size(), 1));
+        std::memcpy(bytes, text.data(), text.size());
+        key.large = bytes;
+    }
+    return key;
+}
+
+void JSONObject::freeKey(const JSONKey& key) {
+    if (key.length > JSONKey::inlineCapacity && !key.interned) {
+        resource()->deallocate(const_cast<char*>(key.large), key.length, 1);
+    }
+}
+
+// Appends a member, building or growing the index once linear search stops paying off
+JSONObject::iterator JSONObject::append(JSONKey key, JSONValue&& value) {
+    members.emplace_back(key, std::move(value));
+    size_t count = members.size();
+    size_t slots = static_cast<size_t>(indexMask) + 1;
+    if (indexMask != 0 && count * 2 <= slots) {
+        size_t slot = std::hash<std::string_view>()(key.view()) & indexMask;
+        while (index[slot] != 0) slot = (slot + 1) & indexMask;
+        index[slot] = static_cast<uint32_t>(count);
+    } else if (count > linearLimit) {
+        buildIndex(slots * 2);
+    }
+    return begin() + (count - 1);
+}
+
+void JSONObject::copyFrom(const JSONObject& other) {
+    members.reserve(other.members.size());
+    for (const value_type& member : other.members) {
+        append(copyKey(member.first.view()), JSONValue(member.second));
+    }
+}
+
+// Rebuilds the index with a power of two of at least minSlots entries, at most half full
+void JSONObject::buildIndex(size_t minSlots) {
+    size_t slots = 32;
+    while (slots < minSlots || slots < members.size() * 2) slots *= 2;
+    releaseIndex();
+    index = static_cast<uint32_t*>(resource()->allocate(slots * sizeof(uint32_t), alignof(uint32_t)));
+    std::memset(index, 0, slots * sizeof(uint32_t));
+    indexMask = static_cast<uint32_t>(slots - 1);
+    for (size_t i = 0; i < members.size(); i++) {
+        size_t slot = std::hash<std::string_view>()(members[i].first.view()) & indexMask;
+        while (index[slot] != 0) slot = (slot + 1) & indexMask;
+        index[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+void JSONObject::releaseIndex() {
+    if (index) resource()->deallocate(index, (static_cast<size_t>(indexMask) + 1) * sizeof(uint32_t), alignof(uint32_t));
+    index = nullptr;
+    indexMask = 0;
+}
+
+// Short keys need no table; long ones are looked up under a shared lock first,
+// so a concurrent table only serializes threads on keys it has not seen yet
+JSONKey JSONKeyTable::intern(std::string_view text) {
+    if (text.size() > UINT32_MAX) throw std::runtime_error("Object key too long");
+    JSONKey key;
+    key.length = static_cast<uint32_t>(text.size());
+    if (text.size() <= JSONKey::inlineCapacity) {
+        std::memcpy(key.small, text.data(), text.size());
+        return key;
+    }
+    key.interned = true;
+    size_t hash = std::hash<std::string_view>()(text);
+
+    if (concurrent) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const std::string_view* found = lookup(text, hash);
+        if (found && !found->empty()) {
+            key.large = found->data();
+            return key;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (concurrent) lock.lock();
+    const std::string_view* found = lookup(text, hash);
+    if (!found || found->empty()) {
+        if ((count + 1) * 2 > slots.size()) {
+            grow();
+            found = lookup(text, hash);
+        }
+        char* bytes = static_cast<char*>(storage.allocate(text.size(), 1));
+        std::memcpy(bytes, text.data(), text.size());
+        *const_cast<std::string_view*>(found) = std::string_view(bytes, text.size());
+        count++;
+    }
+    key.large = found->data();
+    return key;
+}
+
+// The slot holding key, or the empty slot where it belongs; nullptr before the first insert
+const std::string_view* JSONKeyTable::lookup(std::string_view key, size_t hash) const {
+    if (slots.empty()) return nullptr;
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+    while (!slots[slot].empty() && slots[slot] != key) slot = (slot + 1) & mask;
+    return &slots[slot];
+}
+
+void JSONKeyTable::grow() {
+    std::vector<std::string_view> old(std::max<size_t>(64, slots.size() * 2));
+    old.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (std::string_view key : old) {
+        if (key.empty()) continue;
+        size_t slot = std::hash<std::string_view>()(key) & mask;
+        while (!slots[slot].empty()) slot = (slot + 1) & mask;
+        slots[slot] = key;
+    }
+}
+
+size_t JSONKeyTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (concurrent) lock.lock();
+    return count;
+}
+
+// Keeps the slot array and the storage block for the next document
+void JSONKeyTable::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+    if (concurrent) lock.lock();
+    std::fill(slots.begin(), slots.end(), std::string_view());
+    count = 0;
+    storage.reset();
+}
+
+// Arena starts with one block so small documents never grow it
+JSONArena::JSONArena(size_t initialBytes) {
+    addBlock(initialBytes);
+}
+
+JSONArena::~JSONArena() {
+    for (const Block& block : blocks) {
+        ::operator delete(block.data);
+    }
+}
+
+// Appends a block at least minBytes long, doubling the previous block size
+void JSONArena::addBlock(size_t minBytes) {
+    size_t size = blocks.empty() ? minBytes : std::max(minBytes, blocks.back().size * 2);
+    if (!blocks.empty()) usedBefore += offset;
+    blocks.push_back({static_cast<char*>(::operator new(size)), size});
+    offset = 0;
+}
+
+// Bump-allocates from the current block, growing when it is full
+void* JSONArena::do_allocate(size_t bytes, size_t alignment) {
+    auto alignedOffset = [&] {
+        auto base = reinterpret_cast<std::uintptr_t>(blocks.back().data);
+        return ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+    };
+    size_t aligned = alignedOffset();
+    if (aligned + bytes > blocks.back().size) {
+        addBlock(bytes + alignment);
+        aligned = alignedOffset();
+    }
+    offset = aligned + bytes;
+    return blocks.back().data + aligned;
+}
+
+// Forgets every allocation. If the last document spilled into several blocks they
+// are merged into one block of the combined size, so the next parse fits without growing.
+void JSONArena::reset() {
+    if (blocks.size() > 1) {
+        size_t total = bytesReserved();
+        for (const Block& block : blocks) {
+            ::operator delete(block.data);
+        }
+        blocks.clear();
+        usedBefore = 0;
+        addBlock(total);
+    }
+    offset = 0;
+    usedBefore = 0;
+}
+
+size_t JSONArena::bytesUsed() const {
+    return usedBefore + offset;
+}
+
+size_t JSONArena::bytesReserved() const {
+    size_t total = 0;
+    for (const Block& block : blocks) total += block.size;
+    return total;
+}
+
+// Parses into the arena; the previous tree is dropped without running destructors
+const JSONValue& JSONDocument::parse(JSONParser& parser) {
+    release();
+    void* slot = arena.allocate(sizeof(JSONValue), alignof(JSONValue));
+    rootValue = new (slot) JSONValue(parser.parse(&arena, &keys));
+    return *rootValue;
+}
+
+// Parses with the document's own parser, which keeps its buffers between calls
+const JSONValue& JSONDocument::parse(std::string_view json) {
+    parser.reset(json);
+    return parse(parser);
+}
+
+// The arena is reset before parsing, so a rejected document costs no more memory
+// than an accepted one and leaves nothing behind
+JSONError JSONDocument::tryParse(JSONParser& source) noexcept {
+    release();
+    JSONParseResult result = source.tryParse(&arena, &keys);
+    if (!result.ok()) {
+        release();
+        return result.error;
+    }
+    try {
+        void* slot = arena.allocate(sizeof(JSONValue), alignof(JSONValue));
+        rootValue = new (slot) JSONValue(std::move(result.value));
+    } catch (const std::bad_alloc&) {
+        release();
+        result.error.code = JSONErrorCode::OutOfMemory;
+    }
+    return result.error;
+}
+
+JSONError JSONDocument::tryParse(std::string_view json) noexcept {
+    parser.reset(json);
+    return tryParse(parser);
+}
+
+void JSONDocument::parseMany(const std::vector<std::string_view>& inputs,
+                             const std::function<void(size_t index, const JSONValue& root)>& handle) {
+    for (size_t i = 0; i < inputs.size(); i++) {
+        handle(i, parse(inputs[i]));
+    }
+}
+
+const JSONValue& JSONDocument::root() const {
+    if (!rootValue) throw std::runtime_error("JSONDocument is empty");
+    return *rootValue;
+}
+
+// Every node of the read-only tree lives in the arena, so dropping it is O(1)
+void JSONDocument::release() {
+    rootValue = nullptr;
+    arena.reset();
+    keys.clear();
+}
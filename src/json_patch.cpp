@@ -0,0 +1,413 @@
+#include "json_patch.hpp"
+#include "json_number.hpp"
+#include "json_writer.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const char* opName(JSONPatch::Op op) {
+    switch (op) {
+        case JSONPatch::Op::Add: return "add";
+        case JSONPatch::Op::Remove: return "remove";
+        case JSONPatch::Op::Replace: return "replace";
+        case JSONPatch::Op::Move: return "move";
+        case JSONPatch::Op::Copy: return "copy";
+        case JSONPatch::Op::Test: return "test";
+    }
+    return "unknown";
+}
+
+// Splits an RFC 6901 pointer into unescaped tokens; "" is the whole document
+std::vector<std::string> splitPointer(std::string_view pointer) {
+    std::vector<std::string> tokens;
+    if (pointer.empty()) return tokens;
+    if (pointer[0] != '/') throw std::runtime_error("Invalid JSON Pointer: must be empty or start with '/'");
+
+    size_t pos = 1;
+    while (true) {
+        size_t slash = pointer.find('/', pos);
+        std::string_view token = pointer.substr(pos, slash == std::string_view::npos ? std::string_view::npos : slash - pos);
+        std::string& decoded = tokens.emplace_back();
+        decoded.reserve(token.size());
+        for (size_t i = 0; i < token.size(); i++) {
+            if (token[i] != '~') {
+                decoded += token[i];
+                continue;
+            }
+            if (i + 1 == token.size() || (token[i + 1] != '0' && token[i + 1] != '1')) {
+                throw std::runtime_error("Invalid JSON Pointer: '~' must be followed by '0' or '1'");
+            }
+            decoded += token[++i] == '0' ? '~' : '/';
+        }
+        if (slash == std::string_view::npos) break;
+        pos = slash + 1;
+    }
+    return tokens;
+}
+
+void appendPointerToken(std::string& pointer, std::string_view token) {
+    pointer += '/';
+    for (char ch : token) {
+        if (ch == '~') pointer += "~0";
+        else if (ch == '/') pointer += "~1";
+        else pointer += ch;
+    }
+}
+
+// A canonical array index ("0" or no leading zero) below limit, or -1
+int64_t arrayIndex(const std::string& token, size_t limit) {
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0')) return -1;
+    int64_t index = 0;
+    for (char ch : token) {
+        if (ch < '0' || ch > '9') return -1;
+        index = index * 10 + (ch - '0');
+    }
+    return static_cast<size_t>(index) < limit ? index : -1;
+}
+
+// The value the first count tokens lead to, or nullptr
+JSONValue* resolve(JSONValue& root, const std::vector<std::string>& tokens, size_t count) {
+    JSONValue* current = &root;
+    for (size_t i = 0; i < count; i++) {
+        if (current->isObject()) {
+            JSONValue::Object& object = current->asObject();
+            auto it = object.find(tokens[i]);
+            if (it == object.end()) return nullptr;
+            current = &it->second;
+        } else if (current->isArray()) {
+            JSONValue::Array& array = current->asArray();
+            int64_t index = arrayIndex(tokens[i], array.size());
+            if (index < 0) return nullptr;
+            current = &array[static_cast<size_t>(index)];
+        } else {
+            return nullptr;
+        }
+    }
+    return current;
+}
+
+// Each step returns nullptr on success or the reason it failed, so a failed
+// operation is reported once, with its position, by the caller
+
+const char* addValue(JSONValue& root, const std::vector<std::string>& tokens, JSONValue&& value) {
+    if (tokens.empty()) {
+        root = std::move(value);
+        return nullptr;
+    }
+    JSONValue* parent = resolve(root, tokens, tokens.size() - 1);
+    if (!parent) return "parent path not found";
+    const std::string& last = tokens.back();
+    if (parent->isObject()) {
+        parent->asObject().insert_or_assign(last, std::move(value));
+        return nullptr;
+    }
+    if (!parent->isArray()) return "parent is not a container";
+
+    JSONValue::Array& array = parent->asArray();
+    if (last == "-") {
+        array.push_back(std::move(value));
+        return nullptr;
+    }
+    int64_t index = arrayIndex(last, array.size() + 1);
+    if (index < 0) return "array index out of range";
+    array.insert(array.begin() + index, std::move(value));
+    return nullptr;
+}
+
+const char* removeValue(JSONValue& root, const std::vector<std::string>& tokens, JSONValue& removed) {
+    if (tokens.empty()) return "cannot remove the whole document";
+    JSONValue* parent = resolve(root, tokens, tokens.size() - 1);
+    if (!parent) return "path not found";
+    const std::string& last = tokens.back();
+    if (parent->isObject()) {
+        JSONValue::Object& object = parent->asObject();
+        auto it = object.find(last);
+        if (it == object.end()) return "path not found";
+        removed = std::move(it->second);
+        object.erase(last);
+        return nullptr;
+    }
+    if (!parent->isArray()) return "path not found";
+
+    JSONValue::Array& array = parent->asArray();
+    int64_t index = arrayIndex(last, array.size());
+    if (index < 0) return "path not found";
+    removed = std::move(array[static_cast<size_t>(index)]);
+    array.erase(array.begin() + index);
+    return nullptr;
+}
+
+bool isProperPrefix(const std::vector<std::string>& prefix, const std::vector<std::string>& tokens) {
+    if (prefix.size() >= tokens.size()) return false;
+    for (size_t i = 0; i < prefix.size(); i++) {
+        if (prefix[i] != tokens[i]) return false;
+    }
+    return true;
+}
+
+const char* applyOperation(JSONValue& root, const JSONPatch::Operation& operation, JSONValue&& value) {
+    switch (operation.op) {
+        case JSONPatch::Op::Add:
+            return addValue(root, operation.pathTokens, std::move(value));
+        case JSONPatch::Op::Remove: {
+            JSONValue removed;
+            return removeValue(root, operation.pathTokens, removed);
+        }
+        case JSONPatch::Op::Replace: {
+            JSONValue* target = resolve(root, operation.pathTokens, operation.pathTokens.size());
+            if (!target) return "path not found";
+            *target = std::move(value);
+            return nullptr;
+        }
+        case JSONPatch::Op::Move: {
+            // Moving a value onto itself changes nothing, but its location must still exist
+            if (operation.fromTokens == operation.pathTokens) {
+                return resolve(root, operation.fromTokens, operation.fromTokens.size()) ? nullptr : "path not found";
+            }
+            if (isProperPrefix(operation.fromTokens, operation.pathTokens)) return "cannot move a value into itself";
+            JSONValue moved;
+            if (const char* error = removeValue(root, operation.fromTokens, moved)) return error;
+            // addValue only takes the value when it succeeds, so a failed move can put it back
+            const char* error = addValue(root, operation.pathTokens, std::move(moved));
+            if (error) addValue(root, operation.fromTokens, std::move(moved));
+            return error;
+        }
+        case JSONPatch::Op::Copy: {
+            const JSONValue* source = resolve(root, operation.fromTokens, operation.fromTokens.size());
+            if (!source) return "from path not found";
+            return addValue(root, operation.pathTokens, JSONValue(*source));
+        }
+        case JSONPatch::Op::Test: {
+            const JSONValue* target = resolve(root, operation.pathTokens, operation.pathTokens.size());
+            if (!target) return "path not found";
+            return jsonEquals(*target, operation.value) ? nullptr : "test failed";
+        }
+    }
+    return "unknown operation";
+}
+
+[[noreturn]] void failOperation(size_t index, const JSONPatch::Operation& operation, const char* reason) {
+    throw std::runtime_error("JSON Patch operation " + std::to_string(index) + " (" + opName(operation.op) + " " +
+                             operation.path + ") failed: " + reason);
+}
+
+const JSONValue& member(const JSONValue::Object& object, std::string_view key, size_t index) {
+    auto it = object.find(key);
+    if (it == object.end()) {
+        throw std::runtime_error("Invalid JSON Patch: operation " + std::to_string(index) + " has no \"" +
+                                 std::string(key) + "\"");
+    }
+    return it->second;
+}
+
+std::string_view memberString(const JSONValue::Object& object, std::string_view key, size_t index) {
+    const JSONValue& value = member(object, key, index);
+    if (!value.isString()) {
+        throw std::runtime_error("Invalid JSON Patch: \"" + std::string(key) + "\" of operation " +
+                                 std::to_string(index) + " is not a string");
+    }
+    return value.asString();
+}
+
+void diffValues(const JSONValue& from, const JSONValue& to, std::string& path, JSONPatch& patch) {
+    if (from.isObject() && to.isObject()) {
+        const JSONValue::Object& before = from.asObject();
+        const JSONValue::Object& after = to.asObject();
+        size_t length = path.size();
+        for (const auto& [key, value] : before) {
+            if (after.contains(key.view())) continue;
+            appendPointerToken(path, key.view());
+            patch.remove(path);
+            path.resize(length);
+        }
+        for (const auto& [key, value] : after) {
+            appendPointerToken(path, key.view());
+            auto it = before.find(key.view());
+            if (it == before.end()) patch.add(path, value);
+            else diffValues(it->second, value, path, patch);
+            path.resize(length);
+        }
+        return;
+    }
+
+    if (from.isArray() && to.isArray()) {
+        const JSONValue::Array& before = from.asArray();
+        const JSONValue::Array& after = to.asArray();
+        size_t prefix = 0;
+        while (prefix < before.size() && prefix < after.size() && jsonEquals(before[prefix], after[prefix])) prefix++;
+        size_t suffix = 0;
+        while (suffix < before.size() - prefix && suffix < after.size() - prefix &&
+               jsonEquals(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+            suffix++;
+        }
+
+        // Pair up the differing middles, then add or remove what is left over
+        size_t beforeCount = before.size() - prefix - suffix;
+        size_t afterCount = after.size() - prefix - suffix;
+        size_t paired = std::min(beforeCount, afterCount);
+        size_t length = path.size();
+        for (size_t i = 0; i < paired; i++) {
+            appendPointerToken(path, std::to_string(prefix + i));
+            diffValues(before[prefix + i], after[prefix + i], path, patch);
+            path.resize(length);
+        }
+        for (size_t i = paired; i < afterCount; i++) {
+            appendPointerToken(path, std::to_string(prefix + i));
+            patch.add(path, after[prefix + i]);
+            path.resize(length);
+        }
+        appendPointerToken(path, std::to_string(prefix + paired));
+        for (size_t i = paired; i < beforeCount; i++) patch.remove(path);
+        path.resize(length);
+        return;
+    }
+
+    if (!jsonEquals(from, to)) patch.replace(path, to);
+}
+
+} // namespace
+
+JSONPatch& JSONPatch::append(Op op, std::string_view from, std::string_view path, JSONValue value) {
+    Operation operation;
+    operation.op = op;
+    operation.path = std::string(path);
+    operation.pathTokens = splitPointer(path);
+    if (op == Op::Move || op == Op::Copy) {
+        operation.from = std::string(from);
+        operation.fromTokens = splitPointer(from);
+    }
+    operation.value = std::move(value);
+    ops.push_back(std::move(operation));
+    return *this;
+}
+
+JSONPatch& JSONPatch::add(std::string_view path, JSONValue value) {
+    return append(Op::Add, {}, path, std::move(value));
+}
+
+JSONPatch& JSONPatch::remove(std::string_view path) {
+    return append(Op::Remove, {}, path, JSONValue());
+}
+
+JSONPatch& JSONPatch::replace(std::string_view path, JSONValue value) {
+    return append(Op::Replace, {}, path, std::move(value));
+}
+
+JSONPatch& JSONPatch::move(std::string_view from, std::string_view path) {
+    return append(Op::Move, from, path, JSONValue());
+}
+
+JSONPatch& JSONPatch::copy(std::string_view from, std::string_view path) {
+    return append(Op::Copy, from, path, JSONValue());
+}
+
+JSONPatch& JSONPatch::test(std::string_view path, JSONValue value) {
+    return append(Op::Test, {}, path, std::move(value));
+}
+
+// Only add and replace put their value into the document, so only they copy it
+void JSONPatch::apply(JSONValue& document) const& {
+    for (size_t i = 0; i < ops.size(); i++) {
+        const Operation& operation = ops[i];
+        bool stores = operation.op == Op::Add || operation.op == Op::Replace;
+        if (const char* error = applyOperation(document, operation, stores ? JSONValue(operation.value) : JSONValue())) {
+            failOperation(i, operation, error);
+        }
+    }
+}
+
+void JSONPatch::apply(JSONValue& document) && {
+    for (size_t i = 0; i < ops.size(); i++) {
+        Operation& operation = ops[i];
+        bool stores = operation.op == Op::Add || operation.op == Op::Replace;
+        if (const char* error = applyOperation(document, operation, stores ? std::move(operation.value) : JSONValue())) {
+            failOperation(i, operation, error);
+        }
+    }
+}
+
+JSONPatch JSONPatch::fromJSON(const JSONValue& patch) {
+    if (!patch.isArray()) throw std::runtime_error("Invalid JSON Patch: must be an array of operations");
+    JSONPatch result;
+    const JSONValue::Array& items = patch.asArray();
+    result.ops.reserve(items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        if (!items[i].isObject()) {
+            throw std::runtime_error("Invalid JSON Patch: operation " + std::to_string(i) + " is not an object");
+        }
+        const JSONValue::Object& object = items[i].asObject();
+        std::string_view op = memberString(object, "op", i);
+        std::string_view path = memberString(object, "path", i);
+        if (op == "add") result.add(path, member(object, "value", i));
+        else if (op == "remove") result.remove(path);
+        else if (op == "replace") result.replace(path, member(object, "value", i));
+        else if (op == "move") result.move(memberString(object, "from", i), path);
+        else if (op == "copy") result.copy(memberString(object, "from", i), path);
+        else if (op == "test") result.test(path, member(object, "value", i));
+        else throw std::runtime_error("Invalid JSON Patch: unknown op \"" + std::string(op) + "\"");
+    }
+    return result;
+}
+
+JSONPatch JSONPatch::parse(std::string_view json) {
+    return fromJSON(JSONParser(json).parse());
+}
+
+JSONPatch JSONPatch::diff(const JSONValue& from, const JSONValue& to) {
+    JSONPatch patch;
+    std::string path;
+    diffValues(from, to, path, patch);
+    return patch;
+}
+
+JSONValue JSONPatch::toJSON() const {
+    JSONValue::Array items;
+    items.reserve(ops.size());
+    for (const Operation& operation : ops) {
+        JSONValue::Object object;
+        object.insert_or_assign("op", opName(operation.op));
+        if (operation.op == Op::Move || operation.op == Op::Copy) object.insert_or_assign("from", operation.from);
+        object.insert_or_assign("path", operation.path);
+        if (operation.op == Op::Add || operation.op == Op::Replace || operation.op == Op::Test) {
+            object.insert_or_assign("value", operation.value);
+        }
+        items.emplace_back(std::move(object));
+    }
+    return items;
+}
+
+std::string JSONPatch::toString(int indent) const {
+    return JSONWriter::toString(toJSON(), indent);
+}
+
+bool jsonEquals(const JSONValue& a, const JSONValue& b) {
+    if (a.isNumber() && b.isNumber()) {
+        return json_detail::compareNumbers(json_detail::exactNumber(a), json_detail::exactNumber(b)) == 0;
+    }
+    if (a.variant().index() != b.variant().index()) return false;
+
+    if (a.isArray()) {
+        const JSONValue::Array& x = a.asArray();
+        const JSONValue::Array& y = b.asArray();
+        if (x.size() != y.size()) return false;
+        for (size_t i = 0; i < x.size(); i++) {
+            if (!jsonEquals(x[i], y[i])) return false;
+        }
+        return true;
+    }
+    if (a.isObject()) {
+        const JSONValue::Object& x = a.asObject();
+        const JSONValue::Object& y = b.asObject();
+        if (x.size() != y.size()) return false;
+        for (const auto& [key, value] : x) {
+            auto it = y.find(key.view());
+            if (it == y.end() || !jsonEquals(value, it->second)) return false;
+        }
+        return true;
+    }
+    if (a.isString()) return a.asString() == b.asString();
+    if (a.isBool()) return a.asBool() == b.asBool();
+    return true;  // Both null
+}
@@ -0,0 +1,427 @@
+#include "json_query.hpp"
+#include "json_number.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+inline bool isNameChar(char ch) {
+    unsigned char byte = static_cast<unsigned char>(ch);
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' ||
+           ch == '-' || ch == '$' || byte >= 0x80;
+}
+
+inline bool isSpace(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// A canonical non-negative array index ("0" or no leading zero), or -1
+int64_t parseArrayIndex(std::string_view token) {
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0')) return -1;
+    int64_t index = 0;
+    for (char ch : token) {
+        if (ch < '0' || ch > '9') return -1;
+        index = index * 10 + (ch - '0');
+    }
+    return index;
+}
+
+} // namespace
+
+// Recursive-descent compiler for the supported JSONPath subset
+class JSONPathCompiler {
+    public:
+        explicit JSONPathCompiler(std::string_view text) : text(text) {}
+
+        JSONQuery compile() {
+            JSONQuery query;
+            skipSpace();
+            if (!consume('$')) fail("Expected '$'");
+            while (true) {
+                skipSpace();
+                if (atEnd()) break;
+                JSONQuery::Step step;
+                if (consume('.')) {
+                    if (peek() == '.') fail("Recursive descent is not supported");
+                    if (consume('*')) {
+                        step.kind = JSONQuery::StepKind::Wildcard;
+                    } else {
+                        step.key = parseName();
+                    }
+                } else if (consume('[')) {
+                    skipSpace();
+                    if (consume('*')) {
+                        step.kind = JSONQuery::StepKind::Wildcard;
+                    } else if (peek() == '\'' || peek() == '"') {
+                        step.key = parseQuoted();
+                    } else if (consume('?')) {
+                        step.kind = JSONQuery::StepKind::Filter;
+                        parseFilter(step);
+                    } else {
+                        step.kind = JSONQuery::StepKind::Index;
+                        step.index = parseInteger();
+                    }
+                    skipSpace();
+                    if (!consume(']')) fail("Expected ']'");
+                } else {
+                    fail("Expected '.' or '['");
+                }
+                query.steps.push_back(std::move(step));
+            }
+            return query;
+        }
+
+    private:
+        std::string_view text;
+        size_t pos = 0;
+
+        [[noreturn]] void fail(const char* message) const {
+            throw std::runtime_error("Invalid JSONPath: " + std::string(message) + " at offset " + std::to_string(pos));
+        }
+
+        bool atEnd() const { return pos >= text.size(); }
+        char peek() const { return atEnd() ? '\0' : text[pos]; }
+
+        bool consume(char ch) {
+            if (peek() != ch || atEnd()) return false;
+            pos++;
+            return true;
+        }
+
+        void skipSpace() {
+            while (!atEnd() && isSpace(text[pos])) pos++;
+        }
+
+        JSONValue::String parseName() {
+            size_t start = pos;
+            while (!atEnd() && isNameChar(text[pos])) pos++;
+            if (pos == start) fail("Expected a member name");
+            return JSONValue::String(text.substr(start, pos - start));
+        }
+
+        // 'single' or "double" quoted name; a backslash escapes the next character
+        JSONValue::String parseQuoted() {
+            char quote = text[pos++];
+            JSONValue::String name;
+            while (true) {
+                if (atEnd()) fail("Unterminated quoted name");
+                char ch = text[pos++];
+                if (ch == quote) break;
+                if (ch == '\\') {
+                    if (atEnd()) fail("Unterminated quoted name");
+                    ch = text[pos++];
+                }
+                name += ch;
+            }
+            return name;
+        }
+
+        int64_t parseInteger() {
+            bool negative = consume('-');
+            size_t start = pos;
+            int64_t value = 0;
+            while (!atEnd() && text[pos] >= '0' && text[pos] <= '9') {
+                if (pos - start >= 18) fail("Array index too large");
+                value = value * 10 + (text[pos++] - '0');
+            }
+            if (pos == start) fail("Expected an array index, '*', a quoted name or a filter");
+            return negative ? -value : value;
+        }
+
+        // ?( @.a.b ) or ?( @.a.b <op> literal )
+        void parseFilter(JSONQuery::Step& step) {
+            if (!consume('(')) fail("Expected '(' after '?'");
+            skipSpace();
+            if (!consume('@')) fail("Expected '@'");
+            while (true) {
+                if (consume('.')) {
+                    step.filterPath.push_back(parseName());
+                } else if (peek() == '[') {
+                    pos++;
+                    skipSpace();
+                    if (peek() != '\'' && peek() != '"') fail("Expected a quoted name");
+                    step.filterPath.push_back(parseQuoted());
+                    skipSpace();
+                    if (!consume(']')) fail("Expected ']'");
+                } else {
+                    break;
+                }
+            }
+            skipSpace();
+            if (consume(')')) {
+                step.op = JSONQuery::FilterOp::Exists;
+                return;
+            }
+
+            if (consume('=')) {
+                if (!consume('=')) fail("Expected '=='");
+                step.op = JSONQuery::FilterOp::Equal;
+            } else if (consume('!')) {
+                if (!consume('=')) fail("Expected '!='");
+                step.op = JSONQuery::FilterOp::NotEqual;
+            } else if (consume('<')) {
+                step.op = consume('=') ? JSONQuery::FilterOp::LessEqual : JSONQuery::FilterOp::Less;
+            } else if (consume('>')) {
+                step.op = consume('=') ? JSONQuery::FilterOp::GreaterEqual : JSONQuery::FilterOp::Greater;
+            } else {
+                fail("Expected a comparison operator or ')'");
+            }
+
+            skipSpace();
+            if (peek() == '\'' || peek() == '"') {
+                step.operand = parseQuoted();
+            } else {
+                size_t start = pos;
+                while (!atEnd() && !isSpace(text[pos]) && text[pos] != ')') pos++;
+                try {
+                    step.operand = JSONParser(std::string(text.substr(start, pos - start))).parse();
+                } catch (const std::exception&) {
+                    pos = start;
+                    fail("Expected a number, string, true, false or null");
+                }
+                if (step.operand.isArray() || step.operand.isObject()) fail("Filter operands must be scalars");
+            }
+            skipSpace();
+            if (!consume(')')) fail("Expected ')'");
+        }
+};
+
+// Compiles an RFC 6901 pointer; each token may address an object key or an array index
+JSONQuery JSONQuery::pointer(std::string_view pointer) {
+    JSONQuery query;
+    if (pointer.empty()) return query;
+    if (pointer[0] != '/') throw std::runtime_error("Invalid JSON Pointer: must be empty or start with '/'");
+
+    size_t pos = 1;
+    while (true) {
+        size_t slash = pointer.find('/', pos);
+        std::string_view token = pointer.substr(pos, slash == std::string_view::npos ? std::string_view::npos : slash - pos);
+
+        Step step;
+        step.kind = StepKind::KeyOrIndex;
+        for (size_t i = 0; i < token.size(); i++) {
+            if (token[i] != '~') {
+                step.key += token[i];
+                continue;
+            }
+            char escaped = i + 1 < token.size() ? token[++i] : '\0';
+            if (escaped == '0') step.key += '~';
+            else if (escaped == '1') step.key += '/';
+            else throw std::runtime_error("Invalid JSON Pointer: '~' must be followed by '0' or '1'");
+        }
+        step.index = parseArrayIndex(step.key);
+        query.steps.push_back(std::move(step));
+
+        if (slash == std::string_view::npos) break;
+        pos = slash + 1;
+    }
+    return query;
+}
+
+JSONQuery JSONQuery::path(std::string_view expression) {
+    return JSONPathCompiler(expression).compile();
+}
+
+bool JSONQuery::isSingular() const {
+    for (const Step& step : steps) {
+        if (step.kind == StepKind::Wildcard || step.kind == StepKind::Filter) return false;
+    }
+    return true;
+}
+
+const JSONValue* JSONQuery::find(const JSONValue& root) const {
+    const JSONValue* found = nullptr;
+    walk(root, 0, [&](const JSONValue& value) {
+        found = &value;
+        return false;
+    });
+    return found;
+}
+
+std::vector<const JSONValue*> JSONQuery::findAll(const JSONValue& root) const {
+    std::vector<const JSONValue*> found;
+    walk(root, 0, [&](const JSONValue& value) {
+        found.push_back(&value);
+        return true;
+    });
+    return found;
+}
+
+void JSONQuery::forEach(const JSONValue& root, const std::function<void(const JSONValue&)>& visit) const {
+    walk(root, 0, [&](const JSONValue& value) {
+        visit(value);
+        return true;
+    });
+}
+
+JSONLazyValue JSONQuery::find(JSONLazyValue root) const {
+    JSONLazyValue found;
+    walk(root, 0, [&](JSONLazyValue value) {
+        found = value;
+        return false;
+    });
+    return found;
+}
+
+void JSONQuery::forEach(JSONLazyValue root, const std::function<void(JSONLazyValue)>& visit) const {
+    walk(root, 0, [&](JSONLazyValue value) {
+        visit(value);
+        return true;
+    });
+}
+
+std::vector<JSONValue> JSONQuery::extract(std::string_view json) const {
+    JSONLazyDocument document(json);
+    std::vector<JSONValue> values;
+    forEach(document.root(), [&](JSONLazyValue value) { values.push_back(value.materialize()); });
+    return values;
+}
+
+// Applies steps[step] to value and recurses; returns false once visit asks to stop
+bool JSONQuery::walk(const JSONValue& value, size_t step, const std::function<bool(const JSONValue&)>& visit) const {
+    if (step == steps.size()) return visit(value);
+    const Step& current = steps[step];
+
+    switch (current.kind) {
+        case StepKind::Key:
+        case StepKind::KeyOrIndex:
+            if (value.isObject()) {
+                const JSONValue::Object& object = value.asObject();
+                auto it = object.find(current.key);
+                return it == object.end() || walk(it->second, step + 1, visit);
+            }
+            if (current.kind == StepKind::Key || !value.isArray() || current.index < 0) return true;
+            [[fallthrough]];
+        case StepKind::Index: {
+            if (!value.isArray()) return true;
+            const JSONValue::Array& array = value.asArray();
+            int64_t index = current.index < 0 ? static_cast<int64_t>(array.size()) + current.index : current.index;
+            if (index < 0 || static_cast<uint64_t>(index) >= array.size()) return true;
+            return walk(array[static_cast<size_t>(index)], step + 1, visit);
+        }
+        case StepKind::Wildcard:
+        case StepKind::Filter: {
+            bool filter = current.kind == StepKind::Filter;
+            if (value.isArray()) {
+                for (const JSONValue& element : value.asArray()) {
+                    if ((!filter || matches(current, element)) && !walk(element, step + 1, visit)) return false;
+                }
+            } else if (value.isObject()) {
+                for (const auto& member : value.asObject()) {
+                    if ((!filter || matches(current, member.second)) && !walk(member.second, step + 1, visit)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    }
+    return true;
+}
+
+bool JSONQuery::walk(JSONLazyValue value, size_t step, const std::function<bool(JSONLazyValue)>& visit) const {
+    if (step == steps.size()) return visit(value);
+    const Step& current = steps[step];
+
+    switch (current.kind) {
+        case StepKind::Key:
+        case StepKind::KeyOrIndex:
+            if (value.isObject()) {
+                // A repeated key yields its last value, as the DOM keeps it
+                JSONLazyValue child = value[std::string_view(current.key)];
+                return !child.exists() || walk(child, step + 1, visit);
+            }
+            if (current.kind == StepKind::Key || !value.isArray() || current.index < 0) return true;
+            [[fallthrough]];
+        case StepKind::Index: {
+            if (!value.isArray()) return true;
+            // Counting the elements walks the whole array, so only negative indexes do it
+            if (current.index < 0) {
+                int64_t index = static_cast<int64_t>(value.size()) + current.index;
+                if (index < 0) return true;
+                return walk(value[static_cast<size_t>(index)], step + 1, visit);
+            }
+            JSONLazyValue element;
+            try {
+                element = value[static_cast<size_t>(current.index)];
+            } catch (const std::runtime_error&) {
+                return true;  // Past the end, which only the walk to it can tell
+            }
+            return walk(element, step + 1, visit);
+        }
+        case StepKind::Wildcard:
+        case StepKind::Filter: {
+            bool filter = current.kind == StepKind::Filter;
+            bool keepGoing = true;
+            auto visitChild = [&](JSONLazyValue child) {
+                if (keepGoing && (!filter || matches(current, child))) keepGoing = walk(child, step + 1, visit);
+            };
+            if (value.isArray()) {
+                value.forEachElement(visitChild);
+            } else if (value.isObject()) {
+                // Each distinct key once, at its first position, with its last value
+                value.forEachField([&](const std::string&, JSONLazyValue child) { visitChild(child); });
+            }
+            return keepGoing;
+        }
+    }
+    return true;
+}
+
+// Evaluates the filter's comparison against the value the filter path reached.
+// Numbers compare exactly, keeping 64-bit integers apart from the doubles they
+// round to. Values of different types are never equal and never ordered.
+template <typename Value>
+bool JSONQuery::compare(const Step& step, const Value& target) {
+    if (step.op == FilterOp::Exists) return true;
+    const JSONValue& operand = step.operand;
+
+    int order = 0;
+    bool ordered = true;
+    if (operand.isNumber() && target.isNumber()) {
+        order = json_detail::compareNumbers(json_detail::exactNumber(target), json_detail::exactNumber(operand));
+    } else if (operand.isString() && target.isString()) {
+        const auto& text = target.asString();
+        int c = std::string_view(text).compare(std::string_view(operand.asString()));
+        order = c < 0 ? -1 : (c > 0 ? 1 : 0);
+    } else if (operand.isBool() && target.isBool()) {
+        order = target.asBool() == operand.asBool() ? 0 : 1;
+        ordered = false;
+    } else if (operand.isNull() && target.isNull()) {
+        ordered = false;
+    } else {
+        return step.op == FilterOp::NotEqual;
+    }
+
+    switch (step.op) {
+        case FilterOp::Equal: return order == 0;
+        case FilterOp::NotEqual: return order != 0;
+        case FilterOp::Less: return ordered && order < 0;
+        case FilterOp::LessEqual: return ordered && order <= 0;
+        case FilterOp::Greater: return ordered && order > 0;
+        case FilterOp::GreaterEqual: return ordered && order >= 0;
+        case FilterOp::Exists: break;
+    }
+    return true;
+}
+
+bool JSONQuery::matches(const Step& step, const JSONValue& element) {
+    const JSONValue* target = &element;
+    for (const JSONValue::String& key : step.filterPath) {
+        if (!target->isObject()) return false;
+        const JSONValue::Object& object = target->asObject();
+        auto it = object.find(key);
+        if (it == object.end()) return false;
+        target = &it->second;
+    }
+    return compare(step, *target);
+}
+
+bool JSONQuery::matches(const Step& step, JSONLazyValue element) {
+    for (const JSONValue::String& key : step.filterPath) {
+        if (!element.isObject()) return false;
+        element = element[std::string_view(key)];
+        if (!element.exists()) return false;
+    }
+    return compare(step, element);
+}
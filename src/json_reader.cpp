@@ -0,0 +1,276 @@
+#include "json_reader.hpp"
+#include "json_number.hpp"
+#include "json_stage1.hpp"
+#include "json_string.hpp"
+#include <stdexcept>
+
+namespace {
+
+// Validates string escapes without keeping the decoded bytes
+struct DiscardString {
+    size_t size() const { return 0; }
+    void reserve(size_t) {}
+    void append(const char*, size_t) {}
+    void operator+=(char) {}
+};
+
+} // namespace
+
+JSONReader::JSONReader(std::string_view json) : json(json) {}
+
+// Skips whitespace and returns the next byte; running out of input is an error here
+char JSONReader::peekSignificant() {
+    while (index < json.size() && json_detail::isJSONWhitespace(json[index])) index++;
+    if (index >= json.size()) fail("Unexpected end of input");
+    return json[index];
+}
+
+// Numbers and literals must be followed by whitespace, a separator or the end
+void JSONReader::expectDelimiter() {
+    if (index >= json.size()) return;
+    char ch = json[index];
+    if (json_detail::isJSONWhitespace(ch) || ch == ',' || ch == ']' || ch == '}') return;
+    fail("Unexpected character after value");
+}
+
+JSONReader::Type JSONReader::peekType() {
+    char ch = peekSignificant();
+    switch (ch) {
+        case '{': return Type::Object;
+        case '[': return Type::Array;
+        case '"': return Type::String;
+        case 't': case 'f': return Type::Bool;
+        case 'n': return Type::Null;
+        default: break;
+    }
+    if (ch == '-' || json_detail::isDigit(ch)) return Type::Number;
+    fail("Invalid JSON value");
+}
+
+bool JSONReader::readNull() {
+    if (peekSignificant() != 'n') return false;
+    readLiteral("null");
+    return true;
+}
+
+bool JSONReader::readBool() {
+    char ch = peekSignificant();
+    if (ch == 't') {
+        readLiteral("true");
+        return true;
+    }
+    if (ch == 'f') {
+        readLiteral("false");
+        return false;
+    }
+    fail("Expected a boolean");
+}
+
+void JSONReader::readLiteral(std::string_view literal) {
+    if (json.substr(index, literal.size()) != literal) fail("Invalid JSON keyword");
+    index += literal.size();
+    expectDelimiter();
+}
+
+void JSONReader::readNumber(json_detail::ParsedNumber& number) {
+    char ch = peekSignificant();
+    if (ch != '-' && !json_detail::isDigit(ch)) fail("Expected a number");
+
+    const char* first = json.data() + index;
+    const char* end = nullptr;
+    json_detail::NumberError error = json_detail::parseNumber(first, json.data() + json.size(), number, end);
+    switch (error) {
+        case json_detail::NumberError::None: break;
+        case json_detail::NumberError::ExpectedDigit: failAt("Expected digit", end);
+        case json_detail::NumberError::ExpectedFractionDigit: failAt("Expected digit after decimal point", end);
+        case json_detail::NumberError::ExpectedExponentDigit: failAt("Expected digit in exponent", end);
+        case json_detail::NumberError::OutOfRange: failAt("Number out of range", first);
+    }
+    index += static_cast<size_t>(end - first);
+    expectDelimiter();
+}
+
+double JSONReader::readDouble() {
+    json_detail::ParsedNumber number;
+    readNumber(number);
+    switch (number.kind) {
+        case json_detail::NumberKind::Int64: return static_cast<double>(number.i);
+        case json_detail::NumberKind::Uint64: return static_cast<double>(number.u);
+        case json_detail::NumberKind::Double: break;
+    }
+    return number.d;
+}
+
+int64_t JSONReader::readInt64() {
+    size_t start = index;
+    json_detail::ParsedNumber number;
+    readNumber(number);
+    switch (number.kind) {
+        case json_detail::NumberKind::Int64: return number.i;
+        case json_detail::NumberKind::Uint64: break;
+        case json_detail::NumberKind::Double: failAt("Expected an integer", json.data() + start);
+    }
+    failAt("Number does not fit in int64", json.data() + start);
+}
+
+uint64_t JSONReader::readUint64() {
+    size_t start = index;
+    json_detail::ParsedNumber number;
+    readNumber(number);
+    switch (number.kind) {
+        case json_detail::NumberKind::Uint64: return number.u;
+        case json_detail::NumberKind::Int64:
+            if (number.i >= 0) return static_cast<uint64_t>(number.i);
+            break;
+        case json_detail::NumberKind::Double: failAt("Expected an integer", json.data() + start);
+    }
+    failAt("Number does not fit in uint64", json.data() + start);
+}
+
+// Strings without escapes are returned in place; the rest are decoded into scratch
+std::string_view JSONReader::readString() {
+    if (peekSignificant() != '"') fail("Expected a string");
+
+    const char* first = json.data() + index + 1;
+    const char* last = json.data() + json.size();
+    const char* special = nullptr;
+    json_detail::StringError status = json_detail::scanString(first, last, special);
+    if (status == json_detail::StringError::None && *special == '"') {
+        index = static_cast<size_t>(special - json.data()) + 1;
+        return std::string_view(first, static_cast<size_t>(special - first));
+    }
+
+    scratch.clear();
+    const char* end = special;
+    if (status == json_detail::StringError::None) status = json_detail::decodeString(first, last, scratch, end);
+    switch (status) {
+        case json_detail::StringError::None: break;
+        case json_detail::StringError::InvalidEscape: failAt("Invalid escape sequence", end);
+        case json_detail::StringError::InvalidUnicodeEscape: failAt("Invalid \\u escape", end);
+        case json_detail::StringError::UnterminatedEscape: failAt("Unterminated escape sequence", end);
+        case json_detail::StringError::Unterminated: failAt("Unterminated string", end);
+        case json_detail::StringError::ControlCharacter: failAt("Unescaped control character in string", end);
+        case json_detail::StringError::InvalidUTF8: failAt("Invalid UTF-8 in string", end);
+    }
+    index = static_cast<size_t>(end - json.data()) + 1;
+    return scratch;
+}
+
+// Consumes the '{' or '[' the caller has checked
+void JSONReader::openContainer() {
+    if (firstItem.size() >= maxDepth) fail("Maximum nesting depth exceeded");
+    index++;
+    firstItem.push_back(true);
+}
+
+void JSONReader::beginObject() {
+    if (peekSignificant() != '{') fail("Expected an object");
+    openContainer();
+}
+
+// Consumes the separator before the next member and its key, or the closing '}'
+bool JSONReader::nextKey(std::string_view& key) {
+    char ch = peekSignificant();
+    if (ch == '}') {
+        index++;
+        firstItem.pop_back();
+        return false;
+    }
+    if (firstItem.back()) {
+        firstItem.back() = false;
+    } else {
+        if (ch != ',') fail("Expected ',' or '}' after value in object");
+        index++;
+        ch = peekSignificant();
+    }
+    if (ch != '"') fail("Expected string key in object");
+
+    key = readString();
+    if (peekSignificant() != ':') fail("Expected ':' after key");
+    index++;
+    return true;
+}
+
+void JSONReader::beginArray() {
+    if (peekSignificant() != '[') fail("Expected an array");
+    openContainer();
+}
+
+// Consumes the separator before the next element, or the closing ']'
+bool JSONReader::nextElement() {
+    char ch = peekSignificant();
+    if (ch == ']') {
+        index++;
+        firstItem.pop_back();
+        return false;
+    }
+    if (firstItem.back()) {
+        firstItem.back() = false;
+    } else {
+        if (ch != ',') fail("Expected ',' or ']' after value in array");
+        index++;
+    }
+    return true;
+}
+
+void JSONReader::skipValue() {
+    switch (peekType()) {
+        case Type::Object: {
+            beginObject();
+            std::string_view key;
+            while (nextKey(key)) skipValue();
+            return;
+        }
+        case Type::Array:
+            beginArray();
+            while (nextElement()) skipValue();
+            return;
+        case Type::String: {
+            DiscardString discard;
+            const char* first = json.data() + index + 1;
+            const char* end = nullptr;
+            switch (json_detail::decodeString(first, json.data() + json.size(), discard, end)) {
+                case json_detail::StringError::None: break;
+                case json_detail::StringError::InvalidEscape: failAt("Invalid escape sequence", end);
+                case json_detail::StringError::InvalidUnicodeEscape: failAt("Invalid \\u escape", end);
+                case json_detail::StringError::UnterminatedEscape: failAt("Unterminated escape sequence", end);
+                case json_detail::StringError::Unterminated: failAt("Unterminated string", end);
+                case json_detail::StringError::ControlCharacter: failAt("Unescaped control character in string", end);
+                case json_detail::StringError::InvalidUTF8: failAt("Invalid UTF-8 in string", end);
+            }
+            index = static_cast<size_t>(end - json.data()) + 1;
+            return;
+        }
+        case Type::Number: {
+            json_detail::ParsedNumber number;
+            readNumber(number);
+            return;
+        }
+        case Type::Bool:
+            readBool();
+            return;
+        case Type::Null:
+            readLiteral("null");
+            return;
+    }
+}
+
+std::string_view JSONReader::readRaw() {
+    peekSignificant();
+    size_t start = index;
+    skipValue();
+    return json.substr(start, index - start);
+}
+
+void JSONReader::finish() {
+    while (index < json.size() && json_detail::isJSONWhitespace(json[index])) index++;
+    if (index < json.size()) fail("Unexpected data after JSON value");
+}
+
+void JSONReader::fail(const std::string& message) const {
+    throw std::runtime_error(message + " at byte " + std::to_string(index));
+}
+
+void JSONReader::failAt(const char* message, const char* at) const {
+    throw std::runtime_error(std::string(message) + " at byte " + std::to_string(at - json.data()));
+}
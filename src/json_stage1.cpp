@@ -0,0 +1,248 @@
+#include "json_stage1.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JSON_STAGE1_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define JSON_TARGET_AVX2
+#endif
+
+namespace json_detail {
+
+namespace {
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t op = 0;          // { } [ ] : ,
+    uint64_t whitespace = 0;
+};
+
+using ClassifyFn = void (*)(const unsigned char* block, BlockMasks& masks);
+
+inline int countTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+inline int popCount(uint64_t bits) {
+#ifdef _MSC_VER
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((bits * 0x0101010101010101ULL) >> 56);
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+// Portable byte-at-a-time classifier
+[[maybe_unused]] void classifyScalar(const unsigned char* block, BlockMasks& masks) {
+    masks = BlockMasks();
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = uint64_t(1) << i;
+        switch (block[i]) {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': masks.op |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+            default: break;
+        }
+    }
+}
+
+#ifdef JSON_STAGE1_X86
+// 16 bytes per step; SSE2 is part of the x86-64 baseline
+void classifySSE2(const unsigned char* block, BlockMasks& masks) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lowerBit = _mm_set1_epi8(0x20);  // folds '[' ']' onto '{' '}'
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+
+    masks = BlockMasks();
+    for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        __m128i folded = _mm_or_si128(chunk, lowerBit);
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriageReturn)));
+
+        int shift = 16 * i;
+        masks.quote |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+        masks.op |= uint64_t(uint32_t(_mm_movemask_epi8(op))) << shift;
+        masks.whitespace |= uint64_t(uint32_t(_mm_movemask_epi8(ws))) << shift;
+    }
+}
+
+// 32 bytes per step on CPUs that report AVX2
+JSON_TARGET_AVX2 void classifyAVX2(const unsigned char* block, BlockMasks& masks) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lowerBit = _mm256_set1_epi8(0x20);
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+
+    masks = BlockMasks();
+    for (int i = 0; i < 2; i++) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+        __m256i folded = _mm256_or_si256(chunk, lowerBit);
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace), _mm256_cmpeq_epi8(folded, closeBrace)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon), _mm256_cmpeq_epi8(chunk, comma)));
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, carriageReturn)));
+
+        int shift = 32 * i;
+        masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslash)))) << shift;
+        masks.op |= uint64_t(uint32_t(_mm256_movemask_epi8(op))) << shift;
+        masks.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(ws))) << shift;
+    }
+}
+
+bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    if (!osSavesYmm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+struct Kernel {
+    ClassifyFn classify;
+    const char* name;
+};
+
+// Picks the widest classifier the running CPU supports
+Kernel selectKernel() {
+#ifdef JSON_STAGE1_X86
+    if (cpuHasAVX2()) return {classifyAVX2, "avx2"};
+    return {classifySSE2, "sse2"};
+#else
+    return {classifyScalar, "scalar"};
+#endif
+}
+
+const Kernel& kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+// Marks characters preceded by an odd run of backslashes. carry holds bit 0 when
+// the previous block ended with an unfinished escape.
+inline uint64_t findEscaped(uint64_t backslash, uint64_t& carry) {
+    uint64_t escaped = carry;
+    backslash &= ~carry;  // an escaped backslash does not start an escape
+    carry = 0;
+    while (backslash) {
+        int i = countTrailingZeros(backslash);
+        if (i == 63) {
+            carry = 1;
+            break;
+        }
+        escaped |= uint64_t(1) << (i + 1);
+        backslash &= ~(uint64_t(3) << i);
+    }
+    return escaped;
+}
+
+// Bit i becomes the XOR of bits 0..i, turning quote positions into string ranges
+inline uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+} // namespace
+
+void findStructurals(const char* data, size_t length, std::vector<uint32_t>& out) {
+    out.clear();
+    const ClassifyFn classify = kernel().classify;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    uint64_t escapeCarry = 0;  // bit 0: first byte of the next block is escaped
+    uint64_t inStringCarry = 0; // all ones while a string spans the block boundary
+    uint64_t scalarCarry = 0;  // bit 0: previous block ended inside a token
+
+    unsigned char tail[64];
+    BlockMasks masks;
+    for (size_t base = 0; base < length; base += 64) {
+        const unsigned char* block = bytes + base;
+        if (length - base < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, length - base);
+            block = tail;
+        }
+        classify(block, masks);
+
+        uint64_t quotes = masks.quote & ~findEscaped(masks.backslash, escapeCarry);
+        uint64_t inString = prefixXor(quotes) ^ inStringCarry;
+        inStringCarry = uint64_t(static_cast<int64_t>(inString) >> 63);
+
+        uint64_t scalar = ~(masks.op | masks.whitespace | quotes);
+        uint64_t scalarStarts = scalar & ~((scalar << 1) | scalarCarry);
+        scalarCarry = scalar >> 63;
+
+        uint64_t structurals = ((masks.op | scalarStarts) & ~inString) | (quotes & inString);
+        if (!structurals) continue;
+
+        size_t count = out.size();
+        out.resize(count + popCount(structurals));
+        uint32_t* dest = out.data() + count;
+        while (structurals) {
+            *dest++ = static_cast<uint32_t>(base + countTrailingZeros(structurals));
+            structurals &= structurals - 1;
+        }
+    }
+}
+
+const char* stage1Implementation() {
+    return kernel().name;
+}
+
+} // namespace json_detail
@@ -0,0 +1,29 @@
+#ifndef JSON_STAGE1_HPP
+#define JSON_STAGE1_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stage 1 of parsing: classifies the input 64 bytes at a time and records where
+// every token starts, so the recursive-descent stage never scans whitespace.
+namespace json_detail {
+
+// Largest input the 32-bit structural index can address
+constexpr size_t maxStructuralInput = UINT32_MAX;
+
+// Replaces out with the offsets of every structural character outside strings
+// ({ } [ ] : ,), every opening quote and the first byte of every other token
+// (numbers, literals and stray characters). Input must be at most maxStructuralInput bytes.
+void findStructurals(const char* data, size_t length, std::vector<uint32_t>& out);
+
+// Name of the kernel chosen at runtime: "avx2", "sse2" or "scalar"
+const char* stage1Implementation();
+
+// JSON insignificant whitespace
+inline bool isJSONWhitespace(char ch) {
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+} // namespace json_detail
+
+#endif
@@ -0,0 +1,111 @@
+#include "json_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Every counter that is summed; maxDepth is the only one that is not
+constexpr uint64_t JSONParseStats::*summedFields[] = {
+    &JSONParseStats::documents,     &JSONParseStats::failedDocuments, &JSONParseStats::inputBytes,
+    &JSONParseStats::objects,       &JSONParseStats::arrays,          &JSONParseStats::strings,
+    &JSONParseStats::keys,          &JSONParseStats::numbers,         &JSONParseStats::literals,
+    &JSONParseStats::objectBytes,   &JSONParseStats::arrayBytes,      &JSONParseStats::stringBytes,
+    &JSONParseStats::keyBytes,      &JSONParseStats::numberBytes,     &JSONParseStats::literalBytes,
+    &JSONParseStats::allocations,   &JSONParseStats::allocatedBytes,  &JSONParseStats::stage1Cycles,
+    &JSONParseStats::objectCycles,  &JSONParseStats::arrayCycles,     &JSONParseStats::stringCycles,
+    &JSONParseStats::numberCycles,  &JSONParseStats::totalCycles,
+};
+constexpr size_t summedCount = sizeof(summedFields) / sizeof(summedFields[0]);
+
+// One thread's running totals, on cache lines of their own
+struct alignas(64) ThreadCounters {
+    std::atomic<uint64_t> sums[summedCount] = {};
+    std::atomic<uint64_t> maxDepth{0};
+
+    // Empties the counters into stats
+    void drainInto(JSONParseStats& stats) {
+        JSONParseStats drained;
+        for (size_t i = 0; i < summedCount; i++) drained.*summedFields[i] = sums[i].exchange(0, std::memory_order_relaxed);
+        drained.maxDepth = maxDepth.exchange(0, std::memory_order_relaxed);
+        stats.merge(drained);
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadCounters>> threads;
+    JSONParseStats retired;  // Totals of threads that have exited
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Registers the thread on its first parse and folds its counts into the
+// retired totals when it exits
+struct ThreadSlot {
+    std::shared_ptr<ThreadCounters> counters = std::make_shared<ThreadCounters>();
+
+    ThreadSlot() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.threads.push_back(counters);
+    }
+
+    ~ThreadSlot() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        counters->drainInto(shared.retired);
+        shared.threads.erase(std::find(shared.threads.begin(), shared.threads.end(), counters));
+    }
+};
+
+} // namespace
+
+void JSONParseStats::merge(const JSONParseStats& other) {
+    for (auto field : summedFields) this->*field += other.*field;
+    maxDepth = std::max(maxDepth, other.maxDepth);
+}
+
+namespace json_detail {
+
+void recordStats(const JSONParseStats& stats) {
+    thread_local ThreadSlot slot;
+    ThreadCounters& counters = *slot.counters;
+    for (size_t i = 0; i < summedCount; i++) {
+        counters.sums[i].fetch_add(stats.*summedFields[i], std::memory_order_relaxed);
+    }
+    uint64_t depth = counters.maxDepth.load(std::memory_order_relaxed);
+    while (stats.maxDepth > depth &&
+           !counters.maxDepth.compare_exchange_weak(depth, stats.maxDepth, std::memory_order_relaxed)) {
+    }
+}
+
+JSONParseStats collectStats() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    JSONParseStats total = shared.retired;
+    for (const auto& counters : shared.threads) {
+        JSONParseStats live;
+        for (size_t i = 0; i < summedCount; i++) {
+            live.*summedFields[i] = counters->sums[i].load(std::memory_order_relaxed);
+        }
+        live.maxDepth = counters->maxDepth.load(std::memory_order_relaxed);
+        total.merge(live);
+    }
+    return total;
+}
+
+void resetStats() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    JSONParseStats discarded;
+    for (const auto& counters : shared.threads) counters->drainInto(discarded);
+    shared.retired = JSONParseStats();
+}
+
+} // namespace json_detail
@@ -0,0 +1,40 @@
+#ifndef JSON_STATS_HPP
+#define JSON_STATS_HPP
+#include "json_parser.hpp"
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSON_STATS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Process-wide parse statistics. Each thread adds its documents to counters of
+// its own with relaxed atomics, so recording never takes a lock or contends on a
+// cache line with another thread; only reading and resetting the totals do.
+namespace json_detail {
+
+// Time stamp counter on x86, a steady clock in nanoseconds elsewhere
+inline uint64_t readCycles() {
+#ifdef JSON_STATS_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Adds one document's statistics to the calling thread's counters
+void recordStats(const JSONParseStats& stats);
+
+// Sum over live threads and threads that have exited
+JSONParseStats collectStats();
+void resetStats();
+
+} // namespace json_detail
+
+#endif
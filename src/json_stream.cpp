@@ -0,0 +1,322 @@
+#include "json_stream.hpp"
+#include "json_number.hpp"
+#include "json_stage1.hpp"
+#include "json_string.hpp"
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+inline bool isNumberChar(char ch) {
+    return json_detail::isDigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+inline bool isLiteralChar(char ch) {
+    return ch >= 'a' && ch <= 'z';
+}
+
+} // namespace
+
+// Walks one chunk through the grammar state machine. Tokens that run off the end
+// of the chunk are carried in token and completed by the next call.
+void JSONStreamParser::feed(const char* data, size_t length) {
+    chunkStart = data;
+    const char* p = data;
+    const char* end = data + length;
+
+    while (p != end) {
+        switch (state) {
+            case State::String: p = continueString(p, end); continue;
+            case State::Number: p = continueNumber(p, end); continue;
+            case State::Literal: p = continueLiteral(p, end); continue;
+            default: break;
+        }
+
+        char ch = *p;
+        if (json_detail::isJSONWhitespace(ch)) {
+            p++;
+            continue;
+        }
+
+        switch (state) {
+            case State::FirstValueOrEnd:
+                if (ch == ']') {
+                    p++;
+                    endContainer('[');
+                    break;
+                }
+                p = startValue(p);
+                break;
+            case State::Value:
+                p = startValue(p);
+                break;
+            case State::FirstKeyOrEnd:
+                if (ch == '}') {
+                    p++;
+                    endContainer('{');
+                    break;
+                }
+                [[fallthrough]];
+            case State::Key:
+                if (ch != '"') fail("Expected string key in object", p);
+                p++;
+                state = State::String;
+                stringIsKey = true;
+                stringHasEscape = false;
+                break;
+            case State::Colon:
+                if (ch != ':') fail("Expected ':' after key", p);
+                p++;
+                state = State::Value;
+                break;
+            case State::AfterValue:
+                if (containers.back() == '{') {
+                    if (ch == ',') state = State::Key;
+                    else if (ch == '}') endContainer('{');
+                    else fail("Expected ',' or '}' after value in object", p);
+                } else {
+                    if (ch == ',') state = State::Value;
+                    else if (ch == ']') endContainer('[');
+                    else fail("Expected ',' or ']' after value in array", p);
+                }
+                p++;
+                break;
+            case State::Done:
+                fail("Unexpected data after JSON value", p);
+            default:
+                break;
+        }
+    }
+
+    consumed += length;
+}
+
+void JSONStreamParser::finish() {
+    chunkStart = nullptr;
+    if (state == State::Number) {
+        emitNumber(token, nullptr);
+    } else if (state == State::Literal) {
+        emitLiteral(token, nullptr);
+    }
+    if (state != State::Done) fail("Unexpected end of input", nullptr);
+}
+
+void JSONStreamParser::reset() {
+    state = State::Value;
+    containers.clear();
+    token.clear();
+    stringIsKey = false;
+    escapePending = false;
+    stringHasEscape = false;
+    consumed = 0;
+    chunkStart = nullptr;
+}
+
+// Reads the stream in fixed-size chunks until EOF
+void JSONStreamParser::parse(std::istream& in, size_t chunkSize) {
+    std::vector<char> buffer(chunkSize);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        size_t count = static_cast<size_t>(in.gcount());
+        if (count > 0) feed(buffer.data(), count);
+    }
+    if (in.bad()) throw std::runtime_error("Error reading input stream");
+    finish();
+}
+
+// Reads the file descriptor in fixed-size chunks until EOF
+void JSONStreamParser::parse(int fd, size_t chunkSize) {
+    std::vector<char> buffer(chunkSize);
+    while (true) {
+#ifdef _WIN32
+        int count = ::_read(fd, buffer.data(), static_cast<unsigned>(buffer.size()));
+#else
+        ssize_t count = ::read(fd, buffer.data(), buffer.size());
+        if (count < 0 && errno == EINTR) continue;
+#endif
+        if (count < 0) throw std::runtime_error("Error reading file descriptor");
+        if (count == 0) break;
+        feed(buffer.data(), static_cast<size_t>(count));
+    }
+    finish();
+}
+
+// Dispatches on the first byte of a value
+const char* JSONStreamParser::startValue(const char* p) {
+    char ch = *p;
+    switch (ch) {
+        case '{':
+            handler.onStartObject();
+            containers.push_back('{');
+            state = State::FirstKeyOrEnd;
+            return p + 1;
+        case '[':
+            handler.onStartArray();
+            containers.push_back('[');
+            state = State::FirstValueOrEnd;
+            return p + 1;
+        case '"':
+            state = State::String;
+            stringIsKey = false;
+            stringHasEscape = false;
+            return p + 1;
+        case 't': case 'f': case 'n':
+            state = State::Literal;
+            return p;
+        default:
+            if (ch == '-' || json_detail::isDigit(ch)) {
+                state = State::Number;
+                return p;
+            }
+            fail("Invalid JSON value", p);
+    }
+}
+
+// Scans to the closing quote. A string that ends in the same chunk it started in
+// is handed to the handler without being copied.
+const char* JSONStreamParser::continueString(const char* p, const char* end) {
+    const char* start = p;
+    while (p != end) {
+        if (escapePending) {
+            escapePending = false;
+            p++;
+            continue;
+        }
+        p = json_detail::findQuoteOrBackslash(p, end);
+        if (p == end) break;
+        if (*p == '\\') {
+            stringHasEscape = true;
+            escapePending = true;
+            p++;
+            continue;
+        }
+
+        p++; // Include the closing quote
+        if (token.empty()) {
+            emitString(std::string_view(start, static_cast<size_t>(p - start)), p - 1);
+        } else {
+            token.append(start, static_cast<size_t>(p - start));
+            emitString(token, p - 1);
+            token.clear();
+        }
+        return p;
+    }
+    token.append(start, static_cast<size_t>(p - start));
+    return p;
+}
+
+const char* JSONStreamParser::continueNumber(const char* p, const char* end) {
+    const char* start = p;
+    while (p != end && isNumberChar(*p)) p++;
+    if (p == end) {
+        token.append(start, static_cast<size_t>(p - start));
+        return p;
+    }
+    if (token.empty()) {
+        emitNumber(std::string_view(start, static_cast<size_t>(p - start)), start);
+    } else {
+        token.append(start, static_cast<size_t>(p - start));
+        emitNumber(token, start);
+        token.clear();
+    }
+    return p;
+}
+
+const char* JSONStreamParser::continueLiteral(const char* p, const char* end) {
+    const char* start = p;
+    while (p != end && isLiteralChar(*p)) p++;
+    token.append(start, static_cast<size_t>(p - start));
+    if (p == end) return p;
+    emitLiteral(token, start);
+    token.clear();
+    return p;
+}
+
+// raw is the string body including its closing quote
+void JSONStreamParser::emitString(std::string_view raw, const char* errorAt) {
+    std::string_view text = raw.substr(0, raw.size() - 1);
+    const char* end = nullptr;
+    json_detail::StringError status = json_detail::StringError::None;
+    if (stringHasEscape) {
+        scratch.clear();
+        status = json_detail::decodeString(raw.data(), raw.data() + raw.size(), scratch, end);
+        text = scratch;
+    } else {
+        status = json_detail::scanString(raw.data(), raw.data() + raw.size(), end);
+    }
+    switch (status) {
+        case json_detail::StringError::None: break;
+        case json_detail::StringError::InvalidEscape: fail("Invalid escape sequence", errorAt);
+        case json_detail::StringError::InvalidUnicodeEscape: fail("Invalid \\u escape", errorAt);
+        case json_detail::StringError::UnterminatedEscape: fail("Unterminated escape sequence", errorAt);
+        case json_detail::StringError::Unterminated: fail("Unterminated string", errorAt);
+        case json_detail::StringError::ControlCharacter: fail("Unescaped control character in string", errorAt);
+        case json_detail::StringError::InvalidUTF8: fail("Invalid UTF-8 in string", errorAt);
+    }
+
+    if (stringIsKey) {
+        state = State::Colon;
+        handler.onKey(text);
+    } else {
+        valueCompleted();
+        handler.onString(text);
+    }
+}
+
+void JSONStreamParser::emitNumber(std::string_view text, const char* errorAt) {
+    json_detail::ParsedNumber number;
+    const char* end = nullptr;
+    json_detail::NumberError error = json_detail::parseNumber(text.data(), text.data() + text.size(), number, end);
+    switch (error) {
+        case json_detail::NumberError::None: break;
+        case json_detail::NumberError::ExpectedDigit: fail("Expected digit", errorAt);
+        case json_detail::NumberError::ExpectedFractionDigit: fail("Expected digit after decimal point", errorAt);
+        case json_detail::NumberError::ExpectedExponentDigit: fail("Expected digit in exponent", errorAt);
+        case json_detail::NumberError::OutOfRange: fail("Number out of range", errorAt);
+    }
+    if (end != text.data() + text.size()) fail("Invalid number", errorAt);
+
+    valueCompleted();
+    switch (number.kind) {
+        case json_detail::NumberKind::Int64: handler.onInt64(number.i); break;
+        case json_detail::NumberKind::Uint64: handler.onUint64(number.u); break;
+        case json_detail::NumberKind::Double: handler.onNumber(number.d); break;
+    }
+}
+
+void JSONStreamParser::emitLiteral(std::string_view text, const char* errorAt) {
+    if (text == "true") {
+        valueCompleted();
+        handler.onBool(true);
+    } else if (text == "false") {
+        valueCompleted();
+        handler.onBool(false);
+    } else if (text == "null") {
+        valueCompleted();
+        handler.onNull();
+    } else {
+        fail("Invalid JSON keyword", errorAt);
+    }
+}
+
+void JSONStreamParser::endContainer(char open) {
+    containers.pop_back();
+    valueCompleted();
+    if (open == '{') handler.onEndObject();
+    else handler.onEndArray();
+}
+
+void JSONStreamParser::valueCompleted() {
+    state = containers.empty() ? State::Done : State::AfterValue;
+}
+
+void JSONStreamParser::fail(const char* message, const char* at) const {
+    size_t offset = consumed + (at && chunkStart ? static_cast<size_t>(at - chunkStart) : 0);
+    throw std::runtime_error(std::string(message) + " at byte " + std::to_string(offset));
+}
@@ -0,0 +1,288 @@
+#ifndef JSON_STRING_HPP
+#define JSON_STRING_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define JSON_STRING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// JSON string decoding shared by the DOM and streaming parsers. Unescaped runs
+// are found 16 bytes at a time and copied whole; \u escapes (including surrogate
+// pairs) are decoded to UTF-8, and raw bytes must be valid UTF-8 with no
+// unescaped control characters, as RFC 8259 requires.
+namespace json_detail {
+
+enum class StringError {
+    None,
+    InvalidEscape,
+    InvalidUnicodeEscape,  // Bad hex digits or an unpaired surrogate
+    UnterminatedEscape,
+    Unterminated,
+    ControlCharacter,
+    InvalidUTF8
+};
+
+inline int lowestSetBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Returns the first '"' or '\\' in [p, last), or last
+inline const char* findQuoteOrBackslash(const char* p, const char* last) {
+#ifdef JSON_STRING_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask) return p + lowestSetBit(mask);
+        p += 16;
+    }
+#endif
+    while (p != last && *p != '"' && *p != '\\') p++;
+    return p;
+}
+
+// A byte that ends a plain ASCII run: '"', '\\', a control character or any non-ASCII byte
+inline bool isStringSpecial(unsigned char ch) {
+    return ch < 0x20 || ch >= 0x80 || ch == '"' || ch == '\\';
+}
+
+// Returns the first special byte in [p, last), or last
+inline const char* findStringSpecial(const char* p, const char* last) {
+#ifdef JSON_STRING_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(' ');
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // A signed compare flags control characters and, as negative bytes, non-ASCII
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmplt_epi8(chunk, space));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask) return p + lowestSetBit(mask);
+        p += 16;
+    }
+#else
+    // SWAR: test eight bytes per step
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    while (last - p >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        uint64_t quotes = word ^ (ones * '"');
+        uint64_t backslashes = word ^ (ones * '\\');
+        uint64_t special = ((quotes - ones) & ~quotes) | ((backslashes - ones) & ~backslashes) |
+                           ((word - ones * 0x20) & ~word) | word;
+        if (special & highs) break;
+        p += 8;
+    }
+#endif
+    while (p != last && !isStringSpecial(static_cast<unsigned char>(*p))) p++;
+    return p;
+}
+
+// Length of the well-formed UTF-8 sequence at p, or 0. Overlong forms, surrogates
+// and code points past U+10FFFF are rejected (RFC 3629).
+inline size_t utf8SequenceLength(const char* p, const char* last) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(p);
+    size_t available = static_cast<size_t>(last - p);
+    auto continuation = [](unsigned char ch) { return (ch & 0xC0) == 0x80; };
+    unsigned char lead = s[0];
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return available >= 2 && continuation(s[1]) ? 2 : 0;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        unsigned char low = lead == 0xE0 ? 0xA0 : 0x80;
+        unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+        return available >= 3 && s[1] >= low && s[1] <= high && continuation(s[2]) ? 3 : 0;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        unsigned char low = lead == 0xF0 ? 0x90 : 0x80;
+        unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+        return available >= 4 && s[1] >= low && s[1] <= high && continuation(s[2]) && continuation(s[3]) ? 4 : 0;
+    }
+    return 0;
+}
+
+// Scans string content that starts just after the opening quote up to its first
+// escape, checking UTF-8 and control characters on the way. On success end points
+// at the closing quote, in which case the bytes can be used in place, or at the
+// first backslash, in which case the string has to be decoded. On failure end
+// points at the offending byte (or last).
+inline StringError scanString(const char* first, const char* last, const char*& end) {
+    const char* p = first;
+    while (true) {
+        p = findStringSpecial(p, last);
+        if (p == last) {
+            end = p;
+            return StringError::Unterminated;
+        }
+        unsigned char ch = static_cast<unsigned char>(*p);
+        if (ch == '"' || ch == '\\') {
+            end = p;
+            return StringError::None;
+        }
+        if (ch < 0x20) {
+            end = p;
+            return StringError::ControlCharacter;
+        }
+        size_t length = utf8SequenceLength(p, last);
+        if (length == 0) {
+            end = p;
+            return StringError::InvalidUTF8;
+        }
+        p += length;
+    }
+}
+
+// Skips to the closing quote of string content without checking it, or last
+inline const char* findStringEnd(const char* p, const char* last) {
+    while (true) {
+        p = findQuoteOrBackslash(p, last);
+        if (p == last || *p == '"') return p;
+        if (last - p < 2) return last;
+        p += 2;
+    }
+}
+
+inline int hexDigit(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+// Reads the four hex digits after the 'u' at p
+inline StringError readHex4(const char* p, const char* last, uint32_t& value) {
+    if (last - p < 5) return StringError::UnterminatedEscape;
+    value = 0;
+    for (int i = 1; i <= 4; i++) {
+        int digit = hexDigit(p[i]);
+        if (digit < 0) return StringError::InvalidUnicodeEscape;
+        value = (value << 4) | static_cast<uint32_t>(digit);
+    }
+    return StringError::None;
+}
+
+// Decodes the \u escape whose 'u' is at p, and its low surrogate if it is the
+// high half of a pair. Writes UTF-8 to utf8 and returns the bytes consumed, or 0 with error set.
+inline size_t decodeUnicodeEscape(const char* p, const char* last, char* utf8, size_t& utf8Length, StringError& error) {
+    uint32_t code = 0;
+    if ((error = readHex4(p, last, code)) != StringError::None) return 0;
+    size_t consumed = 5;
+    if (code >= 0xDC00 && code <= 0xDFFF) {
+        error = StringError::InvalidUnicodeEscape;
+        return 0;
+    }
+    if (code >= 0xD800 && code <= 0xDBFF) {
+        uint32_t low = 0;
+        if (last - p < 7 || p[5] != '\\' || p[6] != 'u' || readHex4(p + 6, last, low) != StringError::None ||
+            low < 0xDC00 || low > 0xDFFF) {
+            error = StringError::InvalidUnicodeEscape;
+            return 0;
+        }
+        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        consumed = 11;
+    }
+
+    if (code < 0x80) {
+        utf8[0] = static_cast<char>(code);
+        utf8Length = 1;
+    } else if (code < 0x800) {
+        utf8[0] = static_cast<char>(0xC0 | (code >> 6));
+        utf8[1] = static_cast<char>(0x80 | (code & 0x3F));
+        utf8Length = 2;
+    } else if (code < 0x10000) {
+        utf8[0] = static_cast<char>(0xE0 | (code >> 12));
+        utf8[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        utf8[2] = static_cast<char>(0x80 | (code & 0x3F));
+        utf8Length = 3;
+    } else {
+        utf8[0] = static_cast<char>(0xF0 | (code >> 18));
+        utf8[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        utf8[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        utf8[3] = static_cast<char>(0x80 | (code & 0x3F));
+        utf8Length = 4;
+    }
+    error = StringError::None;
+    return consumed;
+}
+
+// Decodes string content that starts just after the opening quote, appending the
+// unescaped bytes to out. A string without escapes is appended in one piece; at
+// the first escape out is reserved for the rest of the string, which the decoded
+// text never outgrows. On success end points at the closing quote; on failure it
+// points at the offending byte (or last).
+template <typename String>
+StringError decodeString(const char* first, const char* last, String& out, const char*& end) {
+    const char* p = first;
+    bool reserved = false;
+    while (true) {
+        const char* special = nullptr;
+        StringError error = scanString(p, last, special);
+        if (error != StringError::None) {
+            end = special;
+            return error;
+        }
+        if (!reserved && *special == '\\') {
+            out.reserve(out.size() + static_cast<size_t>(findStringEnd(special, last) - p));
+            reserved = true;
+        }
+        out.append(p, static_cast<size_t>(special - p));
+        p = special;
+        if (*p == '"') {
+            end = p;
+            return StringError::None;
+        }
+
+        // Backslash escape
+        if (++p == last) {
+            end = p;
+            return StringError::UnterminatedEscape;
+        }
+        switch (*p) {
+            case '"': case '\\': case '/':
+                out += *p;
+                break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                char utf8[4];
+                size_t length = 0;
+                size_t consumed = decodeUnicodeEscape(p, last, utf8, length, error);
+                if (consumed == 0) {
+                    end = p;
+                    return error;
+                }
+                out.append(utf8, length);
+                p += consumed;
+                continue;
+            }
+            default:
+                end = p;
+                return StringError::InvalidEscape;
+        }
+        p++;
+    }
+}
+
+} // namespace json_detail
+
+#endif
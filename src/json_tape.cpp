@@ -0,0 +1,352 @@
+#include "json_tape.hpp"
+#include "json_stream.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+constexpr uint64_t payloadMask = (uint64_t(1) << 56) - 1;
+
+inline uint64_t makeWord(char tag, uint64_t payload) {
+    return (uint64_t(static_cast<unsigned char>(tag)) << 56) | payload;
+}
+
+inline char tagOf(uint64_t word) {
+    return static_cast<char>(word >> 56);
+}
+
+inline std::string_view stringAt(const std::string& strings, uint64_t offset) {
+    const char* entry = strings.data() + offset;
+    uint32_t length;
+    std::memcpy(&length, entry, sizeof(length));
+    return std::string_view(entry + sizeof(length), length);
+}
+
+} // namespace
+
+// Appends words to a JSONTape from parser events or from an existing JSONValue.
+// Open containers are patched with their end index and member count when they close.
+class JSONTapeBuilder : public JSONHandler {
+    public:
+        explicit JSONTapeBuilder(JSONTape& tape)
+            : words(tape.words), strings(tape.strings), countLimit(tape.countLimit) {}
+
+        void onStartObject() override { startContainer('{'); }
+        void onKey(std::string_view key) override {
+            keys.push_back(strings.size());
+            appendString(key);
+        }
+        void onEndObject() override { endContainer('}'); }
+        void onStartArray() override { startContainer('['); }
+        void onEndArray() override { endContainer(']'); }
+        void onString(std::string_view value) override {
+            countElement();
+            appendString(value);
+        }
+        void onNumber(double value) override {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            appendNumber('d', bits);
+        }
+        void onInt64(int64_t value) override { appendNumber('l', static_cast<uint64_t>(value)); }
+        void onUint64(uint64_t value) override { appendNumber('u', value); }
+        void onBool(bool value) override {
+            countElement();
+            words.push_back(makeWord(value ? 't' : 'f', 0));
+        }
+        void onNull() override {
+            countElement();
+            words.push_back(makeWord('n', 0));
+        }
+
+        void append(const JSONValue& value) {
+            if (value.isObject()) {
+                onStartObject();
+                for (const auto& member : value.asObject()) {
+                    onKey(member.first);
+                    append(member.second);
+                }
+                onEndObject();
+            } else if (value.isArray()) {
+                onStartArray();
+                for (const JSONValue& element : value.asArray()) append(element);
+                onEndArray();
+            } else if (value.isString()) {
+                onString(value.asString());
+            } else if (const auto* i = std::get_if<int64_t>(&value.variant())) {
+                onInt64(*i);
+            } else if (const auto* u = std::get_if<uint64_t>(&value.variant())) {
+                onUint64(*u);
+            } else if (value.isNumber()) {
+                onNumber(value.asNumber());
+            } else if (value.isBool()) {
+                onBool(value.asBool());
+            } else {
+                onNull();
+            }
+        }
+
+    private:
+        struct OpenContainer {
+            size_t position;
+            uint64_t count;
+            size_t firstKey;  // Index into keys of the object's first key
+            bool isArray;
+        };
+
+        std::vector<uint64_t>& words;
+        std::string& strings;
+        uint64_t countLimit;  // Counts at or above this are stored as the limit and recounted by walking
+        std::vector<OpenContainer> open;
+        std::vector<uint64_t> keys;  // String offsets of the keys of every open object
+        std::unordered_set<std::string_view> seen;
+
+        // Array elements are counted by the value itself; object members by their distinct keys on close
+        void countElement() {
+            if (!open.empty() && open.back().isArray) open.back().count++;
+        }
+
+        // A repeated key is one member, as in the DOM
+        uint64_t distinctKeys(size_t first) {
+            size_t total = keys.size() - first;
+            if (total < 2) return total;
+            uint64_t count = 0;
+            if (total <= JSONObject::linearLimit) {
+                for (size_t i = first; i < keys.size(); i++) {
+                    size_t j = first;
+                    while (j < i && stringAt(strings, keys[j]) != stringAt(strings, keys[i])) j++;
+                    if (j == i) count++;
+                }
+                return count;
+            }
+            seen.clear();
+            for (size_t i = first; i < keys.size(); i++) seen.insert(stringAt(strings, keys[i]));
+            return seen.size();
+        }
+
+        void startContainer(char tag) {
+            countElement();
+            open.push_back({words.size(), 0, keys.size(), tag == '['});
+            words.push_back(makeWord(tag, 0));
+        }
+
+        void endContainer(char tag) {
+            OpenContainer container = open.back();
+            open.pop_back();
+            words.push_back(makeWord(tag, container.position));
+            if (words.size() > UINT32_MAX) throw std::runtime_error("Document too large for JSONTape");
+            if (!container.isArray) {
+                container.count = distinctKeys(container.firstKey);
+                keys.resize(container.firstKey);
+            }
+            uint64_t count = container.count < countLimit ? container.count : countLimit;
+            words[container.position] = makeWord(tagOf(words[container.position]), words.size() | (count << 32));
+        }
+
+        void appendNumber(char tag, uint64_t bits) {
+            countElement();
+            words.push_back(makeWord(tag, 0));
+            words.push_back(bits);
+        }
+
+        void appendString(std::string_view text) {
+            if (text.size() > UINT32_MAX) throw std::runtime_error("String too long for JSONTape");
+            uint32_t length = static_cast<uint32_t>(text.size());
+            words.push_back(makeWord('"', strings.size()));
+            strings.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            strings.append(text.data(), text.size());
+        }
+};
+
+// Builds the tape from parser events, so the text is validated exactly as
+// JSONStreamParser validates it
+void JSONTape::parse(std::string_view json) {
+    clear();
+    JSONTapeBuilder builder(*this);
+    JSONStreamParser parser(builder);
+    try {
+        parser.feed(json);
+        parser.finish();
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+void JSONTape::parse(std::istream& in) {
+    clear();
+    JSONTapeBuilder builder(*this);
+    JSONStreamParser parser(builder);
+    try {
+        parser.parse(in);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+void JSONTape::assign(const JSONValue& value) {
+    clear();
+    JSONTapeBuilder builder(*this);
+    builder.append(value);
+}
+
+JSONTape JSONTape::fromValue(const JSONValue& value) {
+    JSONTape tape;
+    tape.assign(value);
+    return tape;
+}
+
+void JSONTape::clear() {
+    words.clear();
+    strings.clear();
+}
+
+JSONTapeValue JSONTape::root() const {
+    if (words.empty()) throw std::runtime_error("JSONTape is empty");
+    return JSONTapeValue(this, 0);
+}
+
+uint64_t JSONTapeValue::payload() const {
+    return tape->words[position] & payloadMask;
+}
+
+// Index of the closing word of this array or object
+size_t JSONTapeValue::containerEnd(char open, const char* message) const {
+    if (tag() != open) throw std::runtime_error(message);
+    return tape->skip(position) - 1;
+}
+
+bool JSONTapeValue::asBool() const {
+    if (!isBool()) throw std::runtime_error("JSONTapeValue is not a boolean");
+    return tag() == 't';
+}
+
+double JSONTapeValue::asNumber() const {
+    uint64_t bits = isNumber() ? tape->words[position + 1] : 0;
+    switch (tag()) {
+        case 'l': return static_cast<double>(static_cast<int64_t>(bits));
+        case 'u': return static_cast<double>(bits);
+        case 'd': {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        default: throw std::runtime_error("JSONTapeValue is not a number");
+    }
+}
+
+int64_t JSONTapeValue::asInt64() const {
+    if (!isInteger()) throw std::runtime_error("JSONTapeValue is not an integer");
+    uint64_t bits = tape->words[position + 1];
+    if (tag() == 'u' && bits > static_cast<uint64_t>(INT64_MAX)) {
+        throw std::runtime_error("JSONTapeValue does not fit in int64");
+    }
+    return static_cast<int64_t>(bits);
+}
+
+uint64_t JSONTapeValue::asUint64() const {
+    if (!isInteger()) throw std::runtime_error("JSONTapeValue is not an integer");
+    uint64_t bits = tape->words[position + 1];
+    if (tag() == 'l' && static_cast<int64_t>(bits) < 0) {
+        throw std::runtime_error("JSONTapeValue does not fit in uint64");
+    }
+    return bits;
+}
+
+std::string_view JSONTapeValue::asString() const {
+    if (!isString()) throw std::runtime_error("JSONTapeValue is not a string");
+    return stringAt(tape->strings, payload());
+}
+
+// A repeated key's last value wins, as in the DOM, so the scan runs to the end
+JSONTapeValue JSONTapeValue::operator[](std::string_view key) const {
+    size_t close = containerEnd('{', "JSONTapeValue is not an object");
+    JSONTapeValue found;
+    for (size_t p = position + 1; p < close; p = tape->skip(p + 1)) {
+        if (stringAt(tape->strings, tape->words[p] & payloadMask) == key) found = JSONTapeValue(tape, p + 1);
+    }
+    return found;
+}
+
+// Each key once, at its first position, with the last value given for it
+void JSONTapeValue::distinctMembers(std::vector<std::pair<std::string_view, size_t>>& members) const {
+    size_t close = containerEnd('{', "JSONTapeValue is not an object");
+    members.clear();
+    std::unordered_map<std::string_view, size_t> positions;  // Filled once the object outgrows linear search
+    for (size_t p = position + 1; p < close; p = tape->skip(p + 1)) {
+        std::string_view key = stringAt(tape->strings, tape->words[p] & payloadMask);
+        size_t index = members.size();
+        if (members.size() <= JSONObject::linearLimit) {
+            for (size_t i = 0; i < members.size(); i++) {
+                if (members[i].first == key) index = i;
+            }
+        } else {
+            if (positions.empty()) {
+                for (size_t i = 0; i < members.size(); i++) positions.emplace(members[i].first, i);
+            }
+            auto [it, inserted] = positions.emplace(key, members.size());
+            if (!inserted) index = it->second;
+        }
+        if (index == members.size()) members.emplace_back(key, p + 1);
+        else members[index].second = p + 1;
+    }
+}
+
+JSONTapeValue JSONTapeValue::operator[](size_t index) const {
+    size_t close = containerEnd('[', "JSONTapeValue is not an array");
+    size_t p = position + 1;
+    for (size_t i = 0; i < index && p < close; i++) p = tape->skip(p);
+    if (p >= close) throw std::runtime_error("Array index out of bounds");
+    return JSONTapeValue(tape, p);
+}
+
+size_t JSONTapeValue::size() const {
+    if (!isArray() && !isObject()) throw std::runtime_error("JSONTapeValue is not an array or object");
+    size_t count = static_cast<size_t>(payload() >> 32);
+    if (count < tape->countLimit) return count;
+
+    if (isObject()) {
+        std::vector<std::pair<std::string_view, size_t>> members;
+        distinctMembers(members);
+        return members.size();
+    }
+    count = 0;
+    size_t close = tape->skip(position) - 1;
+    for (size_t p = position + 1; p < close; p = tape->skip(p)) count++;
+    return count;
+}
+
+JSONValue JSONTapeValue::toValue() const {
+    return toValue(0);
+}
+
+// The tape itself nests without limit, but the tree built from it is walked
+// recursively here and by JSONValue's destructor, so depth is bounded as in JSONParser
+JSONValue JSONTapeValue::toValue(size_t depth) const {
+    switch (tag()) {
+        case 't': return true;
+        case 'f': return false;
+        case 'l': return asInt64();
+        case 'u': return asUint64();
+        case 'd': return asNumber();
+        case '"': return asString();
+        case '[': case '{':
+            if (depth >= JSONParser::defaultMaxDepth) throw std::runtime_error("Maximum nesting depth exceeded");
+            break;
+        default: return JSONValue();
+    }
+    if (isArray()) {
+        JSONValue::Array array;
+        array.reserve(size());
+        forEachElement([&](JSONTapeValue element) { array.push_back(element.toValue(depth + 1)); });
+        return array;
+    }
+    JSONValue::Object object;
+    forEachField([&](std::string_view key, JSONTapeValue value) {
+        object.insert_or_assign(key, value.toValue(depth + 1));
+    });
+    return object;
+}
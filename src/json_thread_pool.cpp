@@ -0,0 +1,119 @@
+#include "json_thread_pool.hpp"
+
+namespace json_detail {
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; i++) {
+        ranges.push_back(std::make_unique<Range>());
+    }
+    // Slot 0 belongs to the thread that calls run()
+    for (size_t i = 1; i < threads; i++) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void WorkStealingPool::run(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) return;
+
+    // Deal out contiguous slices so neighbouring tasks start on the same thread
+    size_t threads = ranges.size();
+    for (size_t i = 0; i < threads; i++) {
+        std::lock_guard<std::mutex> lock(ranges[i]->mutex);
+        ranges[i]->begin = taskCount * i / threads;
+        ranges[i]->end = taskCount * (i + 1) / threads;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        currentTask = &task;
+        firstError = nullptr;
+        busyWorkers = workers.size();
+        generation++;
+    }
+    jobReady.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(jobMutex);
+    jobDone.wait(lock, [this] { return busyWorkers == 0; });
+    currentTask = nullptr;
+    if (firstError) std::rethrow_exception(firstError);
+}
+
+void WorkStealingPool::workerLoop(size_t self) {
+    size_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        drain(self);
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            busyWorkers--;
+        }
+        jobDone.notify_one();
+    }
+}
+
+// Runs local tasks, then steals until every range is empty
+void WorkStealingPool::drain(size_t self) {
+    const std::function<void(size_t)>& task = *currentTask;
+    size_t index;
+    while (popLocal(self, index) || (steal(self) && popLocal(self, index))) {
+        try {
+            task(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+}
+
+bool WorkStealingPool::popLocal(size_t self, size_t& task) {
+    Range& range = *ranges[self];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin == range.end) return false;
+    task = range.begin++;
+    return true;
+}
+
+// Moves the back half of another worker's remaining range into our own
+bool WorkStealingPool::steal(size_t self) {
+    size_t threads = ranges.size();
+    for (size_t offset = 1; offset < threads; offset++) {
+        Range& victim = *ranges[(self + offset) % threads];
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            size_t remaining = victim.end - victim.begin;
+            if (remaining == 0) continue;
+            size_t take = (remaining + 1) / 2;
+            begin = victim.end - take;
+            end = victim.end;
+            victim.end = begin;
+        }
+        Range& own = *ranges[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+
+} // namespace json_detail
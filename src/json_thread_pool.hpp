@@ -0,0 +1,60 @@
+#ifndef JSON_THREAD_POOL_HPP
+#define JSON_THREAD_POOL_HPP
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace json_detail {
+
+// Fixed set of worker threads that run index-based jobs with work stealing.
+// Each worker owns a contiguous range of task indices and takes from its front;
+// an idle worker steals the back half of the busiest-looking victim's range, so
+// uneven tasks still spread across all threads.
+class WorkStealingPool {
+    public:
+        // threads counts the calling thread, which also runs tasks
+        explicit WorkStealingPool(size_t threads);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // Runs task(i) for every i in [0, taskCount) and returns once all have finished.
+        // The first exception thrown by a task is rethrown here.
+        void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+        size_t size() const { return ranges.size(); }
+
+    private:
+        struct alignas(64) Range {
+            std::mutex mutex;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        std::vector<std::unique_ptr<Range>> ranges;
+        std::vector<std::thread> workers;
+
+        std::mutex jobMutex;
+        std::condition_variable jobReady;
+        std::condition_variable jobDone;
+        const std::function<void(size_t)>* currentTask = nullptr;
+        size_t generation = 0;
+        size_t busyWorkers = 0;
+        bool stopping = false;
+        std::exception_ptr firstError;
+
+        void workerLoop(size_t self);
+        void drain(size_t self);
+        bool popLocal(size_t self, size_t& task);
+        bool steal(size_t self);
+};
+
+} // namespace json_detail
+
+#endif
@@ -0,0 +1,304 @@
+#include "json_writer.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define JSON_WRITER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Flush threshold when writing to a std::ostream
+constexpr size_t streamChunkBytes = 64 * 1024;
+
+inline bool needsEscape(unsigned char ch) {
+    return ch < 0x20 || ch == '"' || ch == '\\';
+}
+
+inline int lowestSetBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Returns the first byte in [p, end) that must be escaped, or end
+const char* findEscape(const char* p, const char* end) {
+#ifdef JSON_WRITER_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, controlMax), controlMax);
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                    _mm_cmpeq_epi8(chunk, backslash)), control);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask) return p + lowestSetBit(mask);
+        p += 16;
+    }
+#else
+    // SWAR: test eight bytes per step for '"', '\\' or a control character
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    while (end - p >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        uint64_t quotes = word ^ (ones * '"');
+        uint64_t backslashes = word ^ (ones * '\\');
+        uint64_t special = ((quotes - ones) & ~quotes) | ((backslashes - ones) & ~backslashes) |
+                           ((word - ones * 0x20) & ~word);
+        if (special & highs) break;
+        p += 8;
+    }
+#endif
+    while (p != end && !needsEscape(static_cast<unsigned char>(*p))) p++;
+    return p;
+}
+
+void appendEscape(std::string& out, unsigned char ch) {
+    switch (ch) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default: {
+            static const char hex[] = "0123456789abcdef";
+            char escape[6] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0xF]};
+            out.append(escape, sizeof(escape));
+        }
+    }
+}
+
+// Shortest text that parses back to the same double
+void appendDouble(std::string& out, double d) {
+    if (!std::isfinite(d)) {
+        out += "null";  // JSON has no NaN or Infinity
+        return;
+    }
+    char text[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::to_chars(text, text + sizeof(text), d);
+    out.append(text, result.ptr);
+#else
+    int length = std::snprintf(text, sizeof(text), "%.17g", d);
+    out.append(text, static_cast<size_t>(length));
+#endif
+}
+
+template <typename Integer>
+void appendInteger(std::string& out, Integer value) {
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+} // namespace
+
+// Escapes in bulk: unescaped runs are found 16 bytes at a time and copied whole
+void JSONWriter::appendEscaped(std::string& out, std::string_view s) {
+    out.reserve(out.size() + s.size() + 2);
+    out += '"';
+    const char* p = s.data();
+    const char* end = p + s.size();
+    while (p != end) {
+        const char* special = findEscape(p, end);
+        out.append(p, static_cast<size_t>(special - p));
+        if (special == end) break;
+        appendEscape(out, static_cast<unsigned char>(*special));
+        p = special + 1;
+    }
+    out += '"';
+}
+
+void JSONWriter::clear() {
+    buffer.clear();
+    levels.clear();
+    afterKey = false;
+}
+
+const std::string& JSONWriter::write(const JSONValue& value) {
+    clear();
+    writeValue(value);
+    return buffer;
+}
+
+void JSONWriter::write(const JSONValue& value, std::ostream& out) {
+    clear();
+    sink = &out;
+    try {
+        writeValue(value);
+    } catch (...) {
+        sink = nullptr;
+        throw;
+    }
+    sink = nullptr;
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+std::string JSONWriter::toString(const JSONValue& value, int indent) {
+    JSONWriter writer(indent);
+    writer.writeValue(value);
+    return std::move(writer.buffer);
+}
+
+// Writes the separator and indentation that precede the next value
+void JSONWriter::beforeValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (levels.empty()) return;
+    if (levels.back().isObject) throw std::runtime_error("JSONWriter expected a key inside object");
+    if (levels.back().hasItems) buffer += ',';
+    levels.back().hasItems = true;
+    newline();
+}
+
+void JSONWriter::newline() {
+    if (indent <= 0) return;
+    buffer += '\n';
+    buffer.append(levels.size() * static_cast<size_t>(indent), ' ');
+}
+
+// Hands the buffer to the output stream once it is large enough
+void JSONWriter::spill() {
+    if (sink && buffer.size() >= streamChunkBytes) {
+        sink->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+JSONWriter& JSONWriter::beginObject() {
+    beforeValue();
+    buffer += '{';
+    levels.push_back({true, false});
+    return *this;
+}
+
+JSONWriter& JSONWriter::endObject() {
+    if (levels.empty() || !levels.back().isObject || afterKey) {
+        throw std::runtime_error("JSONWriter endObject without matching beginObject");
+    }
+    bool hasItems = levels.back().hasItems;
+    levels.pop_back();
+    if (hasItems) newline();
+    buffer += '}';
+    return *this;
+}
+
+JSONWriter& JSONWriter::beginArray() {
+    beforeValue();
+    buffer += '[';
+    levels.push_back({false, false});
+    return *this;
+}
+
+JSONWriter& JSONWriter::endArray() {
+    if (levels.empty() || levels.back().isObject) {
+        throw std::runtime_error("JSONWriter endArray without matching beginArray");
+    }
+    bool hasItems = levels.back().hasItems;
+    levels.pop_back();
+    if (hasItems) newline();
+    buffer += ']';
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeKey(std::string_view key) {
+    if (levels.empty() || !levels.back().isObject || afterKey) {
+        throw std::runtime_error("JSONWriter key outside of object");
+    }
+    if (levels.back().hasItems) buffer += ',';
+    levels.back().hasItems = true;
+    newline();
+    appendEscaped(buffer, key);
+    buffer += indent > 0 ? ": " : ":";
+    afterKey = true;
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeNull() {
+    beforeValue();
+    buffer += "null";
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeBool(bool b) {
+    beforeValue();
+    buffer += b ? "true" : "false";
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeDouble(double d) {
+    beforeValue();
+    appendDouble(buffer, d);
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeInt64(int64_t i) {
+    beforeValue();
+    appendInteger(buffer, i);
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeUint64(uint64_t u) {
+    beforeValue();
+    appendInteger(buffer, u);
+    return *this;
+}
+
+JSONWriter& JSONWriter::writeString(std::string_view s) {
+    beforeValue();
+    appendEscaped(buffer, s);
+    return *this;
+}
+
+// Serializes a whole tree
+JSONWriter& JSONWriter::writeValue(const JSONValue& value) {
+    const JSONValue::ValueType& v = value.variant();
+    if (const auto* object = std::get_if<JSONValue::Object>(&v)) {
+        beginObject();
+        for (const auto& member : *object) {
+            writeKey(member.first);
+            writeValue(member.second);
+        }
+        endObject();
+        spill();
+    } else if (const auto* array = std::get_if<JSONValue::Array>(&v)) {
+        beginArray();
+        for (const JSONValue& element : *array) {
+            writeValue(element);
+        }
+        endArray();
+        spill();
+    } else if (const auto* s = std::get_if<JSONValue::String>(&v)) {
+        writeString(*s);
+    } else if (const auto* d = std::get_if<double>(&v)) {
+        writeDouble(*d);
+    } else if (const auto* i = std::get_if<int64_t>(&v)) {
+        writeInt64(*i);
+    } else if (const auto* u = std::get_if<uint64_t>(&v)) {
+        writeUint64(*u);
+    } else if (const auto* b = std::get_if<bool>(&v)) {
+        writeBool(*b);
+    } else {
+        writeNull();
+    }
+    return *this;
+}
@@ -0,0 +1,160 @@
+#include "json_bind.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+namespace app {
+
+struct Point {
+    double x = 0;
+    double y = 0;
+};
+JSON_BIND(Point, x, y)
+
+struct User {
+    int64_t id = 0;
+    std::string name;
+    bool active = false;
+    std::optional<std::string> email;
+    std::vector<std::string> tags;
+    std::vector<Point> path;
+    std::map<std::string, int> scores;
+    uint16_t level = 1;
+    JSONValue extra;
+};
+JSON_BIND(User, id, name, active, email, tags, path, scores, level, extra)
+
+} // namespace app
+
+// Returns true if reading json as T throws
+template <typename T>
+bool readFails(const std::string& json) {
+    try {
+        JSONBinder::read<T>(json);
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+int main() {
+    try {
+        // Test the compile-time key table
+        std::cout << "Testing perfect hash..." << std::endl;
+        using Description = json_detail::BoundStruct<app::User>;
+        static_assert(Description::count == 9, "every registered member is described");
+        static_assert(Description::table.find("scores") == 6, "keys resolve at compile time");
+        static_assert(Description::table.find("nope") == Description::count, "unknown keys miss");
+        assert(Description::table.find("id") == 0);
+        assert(Description::table.find("extra") == 8);
+        assert(Description::table.find("i") == Description::count);
+        assert(Description::table.find("") == Description::count);
+
+        // Test reading a struct
+        std::cout << "Testing read..." << std::endl;
+        std::string json = R"({
+            "name": "ann \"the\" admin",
+            "id": 9007199254740993,
+            "unknown": {"deep": [1, {"skip": "me"}], "more": null},
+            "active": true,
+            "email": "ann@example.com",
+            "tags": ["a", "b\nc"],
+            "path": [{"x": 1, "y": 2.5}, {"y": -3, "x": 0.125}],
+            "scores": {"math": 90, "art": -5},
+            "extra": {"free": ["form", 1]}
+        })";
+        app::User user = JSONBinder::read<app::User>(json);
+        assert(user.id == 9007199254740993LL);
+        assert(user.name == "ann \"the\" admin");
+        assert(user.active);
+        assert(user.email && *user.email == "ann@example.com");
+        assert(user.tags.size() == 2 && user.tags[1] == "b\nc");
+        assert(user.path.size() == 2 && user.path[0].y == 2.5 && user.path[1].x == 0.125);
+        assert(user.scores.size() == 2 && user.scores["art"] == -5);
+        assert(user.level == 1);  // Absent keys keep their defaults
+        assert(user.extra["free"][1].asInt64() == 1);
+
+        // Test null into optional and reading into an existing object
+        std::cout << "Testing optional and partial reads..." << std::endl;
+        JSONBinder::read(R"({"email": null, "level": 7})", user);
+        assert(!user.email);
+        assert(user.level == 7);
+        assert(user.name == "ann \"the\" admin");
+
+        // Test write and round trip
+        std::cout << "Testing write..." << std::endl;
+        app::Point point{1.5, -2};
+        assert(JSONBinder::write(point) == R"({"x":1.5,"y":-2})");
+        std::string written = JSONBinder::write(user);
+        assert(written.find("\"email\"") == std::string::npos);  // Empty optionals are omitted
+        app::User copy = JSONBinder::read<app::User>(written);
+        assert(JSONBinder::write(copy) == written);
+        assert(JSONParser(JSONBinder::write(user, 2)).parse()["tags"][1].asString() == "b\nc");
+
+        // Test top-level containers and scalars
+        std::cout << "Testing non-struct roots..." << std::endl;
+        auto points = JSONBinder::read<std::vector<app::Point>>(R"([{"x":1,"y":2},{"x":3,"y":4}])");
+        assert(points.size() == 2 && points[1].y == 4);
+        using Flags = std::unordered_map<std::string, bool>;
+        assert(JSONBinder::read<Flags>(R"({"k": false})").at("k") == false);
+        assert(JSONBinder::read<int>(" 42 ") == 42);
+        assert(JSONBinder::write(std::vector<int>{1, 2}) == "[1,2]");
+
+        // Test JSONReader directly
+        std::cout << "Testing JSONReader..." << std::endl;
+        JSONReader reader(R"({"a": [1, "two", null], "b": false})");
+        assert(reader.peekType() == JSONReader::Type::Object);
+        reader.beginObject();
+        std::string_view key;
+        assert(reader.nextKey(key) && key == "a");
+        assert(reader.readRaw() == R"([1, "two", null])");
+        assert(reader.nextKey(key) && key == "b");
+        assert(!reader.readNull());
+        assert(reader.readBool() == false);
+        assert(!reader.nextKey(key));
+        reader.finish();
+
+        // Test errors
+        std::cout << "Testing errors..." << std::endl;
+        assert(readFails<app::Point>(R"({"x": "1"})"));
+        assert(readFails<app::Point>(R"({"x": 1,})"));
+        assert(readFails<app::Point>(R"({"x": 1} extra)"));
+        assert(readFails<app::Point>(R"({"x": 1)"));
+        assert(readFails<app::Point>(R"({"z": [1, 2,]})"));  // Skipped values are still validated
+        assert(readFails<app::Point>(R"({"z": tru})"));
+        assert(readFails<app::User>(R"({"id": 1.5})"));
+        assert(readFails<app::User>(R"({"level": 70000})"));
+        assert(readFails<app::User>(R"({"level": -1})"));
+        assert(readFails<app::User>(R"({"tags": null})"));
+        assert(readFails<app::User>(R"({"name": "bad \q escape"})"));
+        assert(readFails<int>("12x"));
+        assert(readFails<int>(""));
+
+        // Test hostile nesting hits the depth limit instead of overflowing the stack
+        std::string deep = std::string(500000, '[') + std::string(500000, ']');
+        assert(readFails<app::Point>("{\"z\": " + deep + "}"));
+        JSONReader deepReader(deep);
+        bool threw = false;
+        try {
+            deepReader.skipValue();
+        } catch (const std::runtime_error& e) {
+            threw = std::string(e.what()) == "Maximum nesting depth exceeded at byte 1024";
+        }
+        assert(threw);
+        JSONReader shallow("[[[]]]");
+        shallow.setMaxDepth(3);
+        assert(shallow.readRaw() == "[[[]]]");
+        JSONReader limited("[[[]]]");
+        limited.setMaxDepth(2);
+        threw = false;
+        try { limited.skipValue(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,180 @@
+#include "json_lazy.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Returns true if indexing json throws
+bool indexFails(const std::string& json) {
+    try {
+        JSONLazyDocument doc(json);
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+// Returns true if reading the root as a number throws
+bool numberFails(const std::string& json) {
+    try {
+        JSONLazyDocument doc(json);
+        doc.root().asNumber();
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+int main() {
+    try {
+        // Test field access on a nested document
+        std::cout << "Testing field access..." << std::endl;
+        std::string json = R"({
+            "name": "John Doe",
+            "age": 30,
+            "balance": -12.5,
+            "big": 18446744073709551615,
+            "isStudent": false,
+            "nothing": null,
+            "skipped": {"deep": [1, [2, [3, {"x": "}]"}]]]},
+            "address": {"street": "123 Main St", "city": "Anytown"},
+            "tags": ["a", "b", "c"],
+            "esc\"aped": "line\nbreak"
+        })";
+        JSONLazyDocument doc(json);
+        JSONLazyValue root = doc.root();
+        assert(root.isObject());
+        assert(root.size() == 10);
+        assert(root["name"].asString() == "John Doe");
+        assert(root["age"].isInteger() && root["age"].asInt64() == 30);
+        assert(!root["balance"].isInteger() && root["balance"].asNumber() == -12.5);
+        assert(root["big"].asUint64() == UINT64_MAX);
+        assert(root["isStudent"].isBool() && !root["isStudent"].asBool());
+        assert(root["nothing"].isNull() && root["nothing"].exists());
+        assert(root["address"]["city"].asString() == "Anytown");
+        assert(root["tags"].size() == 3 && root["tags"][2].asString() == "c");
+        assert(root["esc\"aped"].asString() == "line\nbreak");
+
+        // Test missing keys read as null
+        JSONLazyValue missing = root["missing"];
+        assert(!missing.exists() && missing.isNull());
+        assert(!root["nam"].exists() && !root["name "].exists());
+
+        // Test raw text and materializing a subtree
+        assert(root["skipped"].rawJSON() == R"({"deep": [1, [2, [3, {"x": "}]"}]]]})");
+        assert(root["age"].rawJSON() == "30");
+        JSONValue address = root["address"].materialize();
+        assert(address["street"].asString() == "123 Main St");
+        JSONValue deep = root["skipped"]["deep"].materialize();
+        assert(deep[1][1][1]["x"].asString() == "}]");
+
+        // Test iteration
+        std::cout << "Testing iteration..." << std::endl;
+        std::string keys;
+        root.forEachField([&](const std::string& key, JSONLazyValue) { keys += key + ","; });
+        assert(keys == "name,age,balance,big,isStudent,nothing,skipped,address,tags,esc\"aped,");
+        std::string tags;
+        root["tags"].forEachElement([&](JSONLazyValue tag) { tags += tag.asString(); });
+        assert(tags == "abc");
+
+        // Test empty containers and scalar roots
+        JSONLazyDocument emptyArray("[]");
+        assert(emptyArray.root().size() == 0);
+        JSONLazyDocument emptyObject(" { } ");
+        assert(emptyObject.root().size() == 0 && !emptyObject.root()["a"].exists());
+        JSONLazyDocument scalar(" 42 ");
+        assert(scalar.root().asInt64() == 42);
+
+        // Test type errors and bounds
+        std::cout << "Testing errors..." << std::endl;
+        bool threw = false;
+        try { root["name"].asNumber(); } catch (const std::exception&) { threw = true; }
+        assert(threw);
+        threw = false;
+        try { root["tags"][3]; } catch (const std::exception&) { threw = true; }
+        assert(threw);
+        threw = false;
+        try { root["missing"]["x"]; } catch (const std::exception&) { threw = true; }
+        assert(threw);
+
+        // Structural errors are found when the document is indexed
+        assert(indexFails(""));
+        assert(indexFails("[1 2]"));
+        assert(indexFails("{\"a\" 1}"));
+        assert(indexFails("{\"a\": 1,}"));
+        assert(indexFails("[1, 2"));
+        assert(indexFails("[1]]"));
+        assert(indexFails("{1: 2}"));
+        assert(indexFails("[:]"));
+        assert(indexFails("\v1"));
+
+        // Malformed scalars are found when they are read
+        assert(numberFails("12x"));
+        assert(numberFails("1."));
+        assert(numberFails("-"));
+        JSONLazyDocument badLiteral("[truex, nul]");
+        threw = false;
+        try { badLiteral.root()[0].asBool(); } catch (const std::exception&) { threw = true; }
+        assert(threw);
+
+        // Test the lazy and eager parsers agree on a larger document
+        std::cout << "Testing agreement with the DOM parser..." << std::endl;
+        std::string large = "[";
+        for (int i = 0; i < 2000; i++) {
+            if (i > 0) large += ",";
+            large += R"({"id": )" + std::to_string(i) + R"(, "name": "user_)" + std::to_string(i) +
+                     R"(", "scores": [1.5, 2.5], "meta": {"a": {"b": [true, null]}}})";
+        }
+        large += "]";
+        JSONLazyDocument lazy{std::string_view(large)};
+        JSONValue eager = JSONParser(large).parse();
+        size_t index = 0;
+        lazy.root().forEachElement([&](JSONLazyValue record) {
+            const JSONValue& expected = eager[index++];
+            assert(record["id"].asInt64() == expected["id"].asInt64());
+            assert(record["name"].asString() == std::string(expected["name"].asString()));
+            assert(record["meta"]["a"]["b"][0].asBool());
+        });
+        assert(index == 2000);
+        assert(lazy.root()[1999]["id"].asInt64() == 1999);
+
+        // Test repeated keys read as the DOM keeps them: first position, last value
+        for (std::string repeated : {std::string(R"({"a":1,"b":0,"a":2})"),
+                                     std::string(R"({"a":1,"b":0,"c":0,"d":0,"e":0,"f":0,"g":0,"h":0,"i":0,"a":2,"b":3})")}) {
+            JSONLazyDocument lazyRepeated(repeated);
+            JSONValue eagerRepeated = JSONParser(repeated).parse();
+            JSONLazyValue object = lazyRepeated.root();
+            assert(object["a"].asInt64() == 2);
+            assert(object.size() == eagerRepeated.asObject().size());
+            size_t position = 0;
+            object.forEachField([&](const std::string& key, JSONLazyValue value) {
+                const auto& expected = eagerRepeated.asObject().begin()[position++];
+                assert(key == std::string(expected.first));
+                assert(value.asInt64() == expected.second.asInt64());
+            });
+            assert(position == eagerRepeated.asObject().size());
+        }
+
+        // Test memory-mapped input
+        std::cout << "Testing file input..." << std::endl;
+        const char* path = "json_lazy_test_input.json";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << json;
+        }
+        {
+            JSONLazyDocument mapped = JSONLazyDocument::fromFile(path);
+            assert(mapped.root()["address"]["street"].asString() == "123 Main St");
+        }
+        std::remove(path);
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
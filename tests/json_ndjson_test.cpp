@@ -0,0 +1,91 @@
+#include "json_ndjson.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main() {
+    try {
+        // Test ordering, blank lines, CRLF and per-record errors
+        std::cout << "Testing small batch..." << std::endl;
+        std::string input = "{\"id\": 1}\n"
+                            "\n"
+                            "{\"id\": 2}\r\n"
+                            "{\"id\": }\n"
+                            "   \n"
+                            "[3]";
+        NDJSONBatchParser parser(4);
+        assert(parser.threadCount() == 4);
+        std::vector<NDJSONRecord> records = parser.parse(input);
+        assert(records.size() == 4);
+        assert(records[0].ok() && records[0].line == 1 && records[0].value["id"].asInt64() == 1);
+        assert(records[1].ok() && records[1].line == 3 && records[1].value["id"].asInt64() == 2);
+        assert(!records[2].ok() && records[2].line == 4);
+        std::cout << "Caught expected error: " << records[2].error << std::endl;
+        assert(records[3].ok() && records[3].line == 6 && records[3].value[0].asInt64() == 3);
+
+        // Test many chunks keep input order and line numbers across threads
+        std::cout << "Testing large batch..." << std::endl;
+        std::string large;
+        const int recordCount = 50000;
+        for (int i = 0; i < recordCount; i++) {
+            if (i % 1000 == 999) {
+                large += "{\"broken\": \n";
+            } else {
+                large += "{\"id\": " + std::to_string(i) + ", \"name\": \"user_" + std::to_string(i) + "\"}\n";
+            }
+        }
+        parser.setChunkBytes(4096);
+        records = parser.parse(large);
+        assert(records.size() == static_cast<size_t>(recordCount));
+        size_t failures = 0;
+        for (int i = 0; i < recordCount; i++) {
+            const NDJSONRecord& record = records[static_cast<size_t>(i)];
+            assert(record.line == static_cast<size_t>(i + 1));
+            if (i % 1000 == 999) {
+                assert(!record.ok());
+                failures++;
+            } else {
+                assert(record.ok());
+                assert(record.value["id"].asInt64() == i);
+            }
+        }
+        assert(failures == recordCount / 1000);
+
+        // Test ordered callback delivery
+        std::cout << "Testing callback delivery..." << std::endl;
+        size_t expectedLine = 1;
+        parser.parse(large, [&](NDJSONRecord& record) {
+            assert(record.line == expectedLine);
+            expectedLine++;
+        });
+        assert(expectedLine == static_cast<size_t>(recordCount + 1));
+
+        // Test the single-threaded configuration gives the same answer
+        NDJSONBatchParser serial(1);
+        serial.setChunkBytes(1000);
+        assert(serial.parse(large).size() == static_cast<size_t>(recordCount));
+
+        // Test memory-mapped file input
+        std::cout << "Testing file input..." << std::endl;
+        const char* path = "json_ndjson_test_input.ndjson";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << input;
+        }
+        std::vector<NDJSONRecord> fileRecords = parser.parseFile(path);
+        std::remove(path);
+        assert(fileRecords.size() == 4);
+        assert(fileRecords[3].value[0].asInt64() == 3);
+
+        // Test empty input
+        assert(parser.parse(std::string_view()).empty());
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -1,6 +1,28 @@
 #include "json_parser.hpp"
+#include <atomic>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Counts every heap allocation in the process, so tests can prove a path makes none
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
 
 int main() {
     try {
@@ -27,6 +49,8 @@ int main() {
         std::cout << "Checking name value..." << std::endl;
         assert(json["name"].isString());
         assert(json["name"].asString() == "Alice");
+        std::string_view nameView = json["name"].asStringView();
+        assert(nameView == "Alice" && nameView.data() == json["name"].asString().data());
         
         std::cout << "Checking age value..." << std::endl;
         assert(json["age"].isNumber());
@@ -109,6 +133,398 @@ int main() {
         assert(nested["data"]["people"][0]["name"].asString() == "Bob");
         assert(nested["data"]["people"][1]["hobbies"][2].asString() == "singing");
         
+        // Test zero-copy parsing from caller-owned buffers
+        std::cout << "Testing zero-copy input..." << std::endl;
+        std::string buffer = R"({"id": 7, "tags": ["a", "b"]} trailing)";
+        JSONParser viewParser(std::string_view(buffer).substr(0, buffer.find(" trailing")));
+        JSONValue viewed = viewParser.parse();
+        assert(viewed["id"].asNumber() == 7);
+        assert(viewed["tags"][1].asString() == "b");
+        
+        JSONParser rawParser(buffer.data(), buffer.find(" trailing"));
+        assert(rawParser.parse()["tags"].asArray().size() == 2);
+        
+        // Test copying constructor keeps its own storage after a move
+        std::string temporary = R"(["moved"])";
+        JSONParser owningParser(temporary);
+        temporary.assign("garbage");
+        JSONParser movedParser = std::move(owningParser);
+        assert(movedParser.parse()[0].asString() == "moved");
+        
+        // Test memory-mapped file input
+        std::cout << "Testing memory-mapped file..." << std::endl;
+        const char* mappedPath = "json_parser_test_mapped.json";
+        {
+            std::ofstream out(mappedPath, std::ios::binary);
+            out << R"({ "mapped": true, "values": [1, 2, 3] })";
+        }
+        {
+            JSONParser fileParser = JSONParser::fromFile(mappedPath);
+            JSONValue mapped = fileParser.parse();
+            assert(mapped["mapped"].asBool());
+            assert(mapped["values"][2].asNumber() == 3);
+        }
+        std::remove(mappedPath);
+        
+        try {
+            JSONParser::fromFile("json_parser_test_missing.json");
+            assert(false);
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught expected error: " << e.what() << std::endl;
+        }
+        
+        // Test arena-backed parsing
+        std::cout << "Testing arena allocation..." << std::endl;
+        JSONArena arena(1024);
+        {
+            JSONParser arenaParser(R"({"list": [1, 2, 3], "text": "a string longer than the small buffer"})");
+            JSONValue arenaValue = arenaParser.parse(&arena);
+            assert(arenaValue["list"].asArray().get_allocator().resource() == &arena);
+            assert(arenaValue["text"].asString().get_allocator().resource() == &arena);
+            assert(arenaValue["text"].asString() == "a string longer than the small buffer");
+            assert(arena.bytesUsed() > 0);
+            
+            // Copies are independent of the arena
+            JSONValue copied = arenaValue;
+            assert(copied["list"].asArray().get_allocator().resource() != &arena);
+        }
+        arena.reset();
+        assert(arena.bytesUsed() == 0);
+        
+        // Test document reuse settles into a single arena block
+        std::cout << "Testing document reuse..." << std::endl;
+        std::string bigArray = "[";
+        for (int i = 0; i < 1000; i++) {
+            bigArray += (i ? ",\"item_" : "\"item_") + std::to_string(i) + "_with_a_long_suffix\"";
+        }
+        bigArray += "]";
+        JSONDocument document(256);
+        for (int round = 0; round < 3; round++) {
+            JSONParser documentParser{std::string_view(bigArray)};
+            const JSONValue& root = document.parse(documentParser);
+            assert(root.asArray().size() == 1000);
+            assert(root[999].asString() == "item_999_with_a_long_suffix");
+        }
+        assert(document.memory().blockCount() == 1);
+        document.release();
+        assert(document.empty());
+        
+        // Test structural indexing across 64-byte block boundaries
+        std::cout << "Testing structural index edge cases..." << std::endl;
+        for (size_t pad = 0; pad < 70; pad++) {
+            std::string padded = std::string(pad, ' ') +
+                R"({"a\\": "x\"y,}]", "b\\\"": [1, {"c": "\\\\"}], "d": true})";
+            JSONValue edge = JSONParser(padded).parse();
+            assert(edge["a\\"].asString() == "x\"y,}]");
+            assert(edge["b\\\""][1]["c"].asString() == "\\\\");
+            assert(edge["d"].asBool());
+        }
+        
+        const char* invalidDocuments[] = {"12x", "[truex]", "[1 2]", "{\"a\" 1}", "[\"open", "\v1"};
+        for (const char* invalid : invalidDocuments) {
+            try {
+                JSONParser(invalid).parse();
+                assert(false);
+            } catch (const std::runtime_error& e) {
+                std::cout << "Caught expected error: " << e.what() << std::endl;
+            }
+        }
+        
+        // Test string decoding: \u escapes, surrogate pairs and UTF-8 validation
+        std::cout << "Testing string decoding..." << std::endl;
+        JSONValue unicode = JSONParser(R"({"caf\u00e9": "\u0041\u00DF\u6771\ud83d\ude00", )"
+                                       "\"raw\": \"na\xc3\xafve \xe6\x9d\xb1 \xf0\x9f\x98\x80\"}").parse();
+        assert(unicode["caf\xc3\xa9"].asString() == "A\xc3\x9f\xe6\x9d\xb1\xf0\x9f\x98\x80");
+        assert(unicode["raw"].asString() == "na\xc3\xafve \xe6\x9d\xb1 \xf0\x9f\x98\x80");
+        
+        // Escapes at every position around the 16-byte scanning blocks
+        for (size_t pad = 0; pad < 40; pad++) {
+            std::string filler(pad, 'x');
+            JSONValue padded = JSONParser("[\"" + filler + "\\n" + filler + "\\u00e9\"]").parse();
+            assert(std::string_view(padded[0].asString()) == filler + "\n" + filler + "\xc3\xa9");
+        }
+        
+        const char* invalidStrings[] = {
+            "\"\\ud800\"", "\"\\udc00\"", "\"\\ud800\\u0041\"", "\"\\u12g4\"", "\"\\u12",
+            "\"\xc3\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "\"\xff\"", "\"a\tb\"",
+            "{\"k\x80\": 1}"};
+        for (const char* invalid : invalidStrings) {
+            try {
+                JSONParser(invalid).parse();
+                assert(false);
+            } catch (const std::runtime_error& e) {
+                std::cout << "Caught expected error: " << e.what() << std::endl;
+            }
+        }
+        assert(JSONParser("\"\\ud800\"").tryParse().error.code == JSONErrorCode::InvalidUnicodeEscape);
+        assert(JSONParser("\"ok\xc3(\"").tryParse().error.offset == 3);
+        assert(JSONParser("\"a\nb\"").tryParse().error.code == JSONErrorCode::ControlCharacter);
+        
+        // Test number parsing keeps 64-bit integers exact
+        std::cout << "Testing number parsing..." << std::endl;
+        JSONValue numberList = JSONParser(R"([-9223372036854775808, 18446744073709551615, 18446744073709551616,
+                                              0.1, -2.5e-3, 1E2, 123456789012.345678, -0, 9007199254740993])").parse();
+        assert(numberList[0].asInt64() == INT64_MIN);
+        assert(numberList[1].asUint64() == UINT64_MAX);
+        assert(!numberList[2].isInteger() && numberList[2].asNumber() == 18446744073709551616.0);
+        assert(numberList[3].asNumber() == 0.1);
+        assert(numberList[4].asNumber() == -2.5e-3);
+        assert(numberList[5].asNumber() == 100.0);
+        assert(numberList[6].asNumber() == 123456789012.345678);
+        assert(!numberList[7].isInteger() && numberList[7].asNumber() == 0.0);
+        assert(numberList[8].isInteger() && numberList[8].asInt64() == 9007199254740993LL);
+        
+        JSONValue constructed = JSONValue(static_cast<uint64_t>(UINT64_MAX));
+        assert(constructed.isInteger() && constructed.asUint64() == UINT64_MAX);
+        
+        const char* invalidNumbers[] = {"-", "1.", "1.e5", "2e", "2e+", "1e400"};
+        for (const char* invalid : invalidNumbers) {
+            try {
+                JSONParser(invalid).parse();
+                assert(false);
+            } catch (const std::runtime_error& e) {
+                std::cout << "Caught expected error: " << e.what() << std::endl;
+            }
+        }
+        
+        // Test objects keep insertion order and switch to an index when they grow
+        std::cout << "Testing object storage..." << std::endl;
+        JSONValue ordered = JSONParser(R"({"zeta": 1, "alpha": 2, "a key longer than sixteen bytes": 3, "zeta": 4})").parse();
+        const JSONValue::Object& members = ordered.asObject();
+        assert(members.size() == 3);
+        assert(members.begin()->first == "zeta" && members.begin()->second.asInt64() == 4);  // Duplicates keep their place
+        assert((members.begin() + 2)->first == "a key longer than sixteen bytes");
+        assert(members.at("a key longer than sixteen bytes").asInt64() == 3);
+        assert(members.count("alph") == 0 && !members.contains("alphas"));
+        
+        JSONValue::Object wide;
+        for (int i = 0; i < 100; i++) wide["key_" + std::to_string(i) + (i % 2 ? "_with_a_long_tail" : "")] = i;
+        assert(wide.size() == 100);
+        for (int i = 0; i < 100; i++) {
+            assert(wide.at("key_" + std::to_string(i) + (i % 2 ? "_with_a_long_tail" : "")).asInt64() == i);
+        }
+        assert(wide.find("key_100") == wide.end());
+        assert(wide.erase("key_0") == 1 && wide.erase("key_0") == 0);
+        assert(wide.size() == 99 && wide.begin()->first == "key_1_with_a_long_tail");
+        assert(wide.at("key_98").asInt64() == 98);
+
+        // Erasing fixes the index up in place; every survivor stays reachable and in order
+        JSONValue::Object shrinking;
+        std::vector<int> alive;
+        for (int i = 0; i < 300; i++) {
+            shrinking["k" + std::to_string(i)] = i;
+            alive.push_back(i);
+        }
+        unsigned seed = 12345;
+        while (!alive.empty()) {
+            seed = seed * 1103515245 + 12345;
+            size_t victim = (seed >> 8) % alive.size();
+            assert(shrinking.erase("k" + std::to_string(alive[victim])) == 1);
+            alive.erase(alive.begin() + static_cast<std::ptrdiff_t>(victim));
+            if (alive.size() % 7 == 0) {
+                size_t position = 0;
+                for (const auto& member : shrinking) {
+                    assert(member.second.asInt64() == alive[position++]);
+                }
+                for (int key : alive) assert(shrinking.at("k" + std::to_string(key)).asInt64() == key);
+            }
+        }
+        assert(shrinking.empty() && shrinking.indexBytes() == 0);
+        
+        JSONValue::Object wideCopy = wide;
+        wide.clear();
+        assert(wide.empty() && wideCopy.size() == 99 && wideCopy.at("key_99_with_a_long_tail").asInt64() == 99);
+        JSONValue::Object moved = std::move(wideCopy);
+        assert(moved.size() == 99 && moved.count("key_50") == 1);
+        
+        // Test key interning shares long keys across objects
+        std::cout << "Testing key interning..." << std::endl;
+        std::string records = "[";
+        for (int i = 0; i < 50; i++) {
+            records += (i ? "," : "") + std::string(R"({"id": )") + std::to_string(i) +
+                       R"(, "a_rather_long_field_name": "x", "esc\/aped": 1})";
+        }
+        records += "]";
+        JSONKeyTable keyTable;
+        JSONArena keyArena;
+        JSONValue interned = JSONParser{std::string_view(records)}.parse(&keyArena, &keyTable);
+        assert(keyTable.size() == 1);  // Only the long key needs the table
+        const JSONKey& firstKey = (interned[0].asObject().begin() + 1)->first;
+        const JSONKey& lastKey = (interned[49].asObject().begin() + 1)->first;
+        assert(firstKey.isInterned() && firstKey.data() == lastKey.data());
+        assert(interned[49]["a_rather_long_field_name"].asString() == "x");
+        assert(interned[3]["esc/aped"].asInt64() == 1);
+        
+        JSONValue detached = interned;  // Copies own their keys
+        assert(!(detached[0].asObject().begin() + 1)->first.isInterned());
+        
+        JSONKeyTable sharedTable(true);
+        std::vector<std::thread> workers;
+        std::vector<const char*> seen(4);
+        for (size_t t = 0; t < seen.size(); t++) {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < 1000; i++) sharedTable.intern("field_" + std::to_string(i) + "_shared_by_threads");
+                seen[t] = sharedTable.intern("field_7_shared_by_threads").data();
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
+        assert(sharedTable.size() == 1000);
+        for (const char* data : seen) assert(data == seen[0]);
+        
+        // Test a reused document parses small documents without touching the heap
+        std::cout << "Testing steady-state allocations..." << std::endl;
+        std::vector<std::string> bodies;
+        for (int i = 0; i < 64; i++) {
+            bodies.push_back(R"({"request_id": )" + std::to_string(i) + R"(, "user": {"name": "user number )" +
+                             std::to_string(i) + R"( with a long name", "roles": ["admin", "a role name past the small buffer"]},
+                               "tab\tkey": [1.5, true, null, {"nested_object_key_name": )" + std::to_string(-i) + "}]}");
+        }
+        std::vector<std::string_view> views(bodies.begin(), bodies.end());
+        JSONDocument reused(1024);
+        size_t checksum = 0;
+        auto handle = [&](size_t, const JSONValue& root) {
+            checksum += root["request_id"].asUint64() + root["user"]["roles"][1].asString().size();
+            checksum += root["tab\tkey"][3]["nested_object_key_name"].isInteger();
+        };
+        reused.parseMany(views, handle);  // Warm up: arena, key table and parser buffers grow here
+        reused.parseMany(views, handle);
+        size_t before = allocationCount.load();
+        for (int round = 0; round < 20; round++) reused.parseMany(views, handle);
+        assert(allocationCount.load() == before);
+        assert(checksum == 22 * (64 * 63 / 2 + 64 * 33 + 64));
+        assert(reused.root()["user"]["name"].asString() == "user number 63 with a long name");
+        
+        JSONParser reusedParser;
+        reusedParser.reset(views[5]);
+        assert(reusedParser.parse()["request_id"].asInt64() == 5);
+        
+        // Test the non-throwing parse path reports codes and locations
+        std::cout << "Testing error codes..." << std::endl;
+        JSONParseResult good = JSONParser(R"({"ok": [1, 2]})").tryParse();
+        assert(good.ok() && good.value["ok"][1].asInt64() == 2);
+        
+        struct ErrorCase {
+            const char* text;
+            JSONErrorCode code;
+            size_t offset, line, column;
+        };
+        const ErrorCase errorCases[] = {
+            {"{\n  \"a\": 1,\n  \"b\" 2\n}", JSONErrorCode::ExpectedColon, 18, 3, 7},
+            {"[1, 2", JSONErrorCode::UnexpectedEnd, 5, 1, 6},
+            {"[1 2]", JSONErrorCode::ExpectedCommaOrBracket, 3, 1, 4},
+            {"{\"a\": 1 \"b\"}", JSONErrorCode::ExpectedCommaOrBrace, 8, 1, 9},
+            {"{1: 2}", JSONErrorCode::ExpectedKey, 1, 1, 2},
+            {"[truex]", JSONErrorCode::ExpectedCommaOrBracket, 5, 1, 6},
+            {"[nul]", JSONErrorCode::InvalidKeyword, 1, 1, 2},
+            {"\"\\q\"", JSONErrorCode::InvalidEscape, 2, 1, 3},
+            {"[\"open", JSONErrorCode::UnterminatedString, 6, 1, 7},
+            {"1.e5", JSONErrorCode::ExpectedFractionDigit, 2, 1, 3},
+            {"\n\n  @", JSONErrorCode::InvalidValue, 4, 3, 3},
+            {"12 3", JSONErrorCode::TrailingData, 3, 1, 4},
+            {"", JSONErrorCode::UnexpectedEnd, 0, 1, 1},
+        };
+        for (const ErrorCase& expected : errorCases) {
+            JSONParseResult failed = JSONParser(expected.text).tryParse();
+            assert(!failed.ok() && failed.value.isNull());
+            assert(failed.error.code == expected.code);
+            assert(failed.error.offset == expected.offset);
+            assert(failed.error.line == expected.line && failed.error.column == expected.column);
+        }
+        
+        try {
+            JSONParser("[1,\n 2,\n x]").parse();
+            assert(false);
+        } catch (const std::runtime_error& e) {
+            assert(std::string(e.what()) == "Invalid JSON value at line 3, column 2");
+        }
+        
+        // A reused document rejects garbage without touching the heap
+        std::string garbage = bodies[7].substr(0, bodies[7].size() / 2);
+        assert(reused.tryParse(garbage).code == JSONErrorCode::UnterminatedString);
+        assert(reused.empty());
+        before = allocationCount.load();
+        for (int round = 0; round < 100; round++) {
+            assert(reused.tryParse(garbage));
+            assert(!reused.tryParse(views[round % views.size()]));
+        }
+        assert(allocationCount.load() == before);
+        assert(reused.root()["request_id"].asInt64() == 99 % 64);
+
+        // A failure inside an object whose finished members span several arena blocks
+        // leaves nothing behind that points into them once the arena is reset
+        JSONDocument spanning(256);
+        std::string unfinished = "{\"a\": [";
+        for (int i = 0; i < 2000; i++) {
+            unfinished += (i ? ",\"" : "\"") + std::string(40, 'x') + "\"";
+        }
+        unfinished += "], \"b\": x}";
+        assert(spanning.tryParse(unfinished).code == JSONErrorCode::InvalidValue);
+        assert(spanning.empty());
+        assert(!spanning.tryParse("{}"));
+        assert(spanning.root().asObject().empty());
+        JSONArena shortLived(256);
+        JSONParser outlivesArena{std::string_view(unfinished)};
+        assert(!outlivesArena.tryParse(&shortLived).ok());
+        shortLived.reset();
+        outlivesArena.reset("{\"c\": 1}");
+        assert(outlivesArena.tryParse(&shortLived).value["c"].asInt64() == 1);
+        
+        // Test the depth limit turns hostile nesting into an error instead of a stack overflow
+        std::cout << "Testing depth limit..." << std::endl;
+        std::string deepArrays = std::string(100000, '[') + std::string(100000, ']');
+        JSONParseResult tooDeep = JSONParser(deepArrays).tryParse();
+        assert(tooDeep.error.code == JSONErrorCode::DepthLimitExceeded);
+        assert(tooDeep.error.offset == JSONParser::defaultMaxDepth);
+        std::string deepObjects;
+        for (int i = 0; i < 2000; i++) deepObjects += "{\"a\":";
+        deepObjects += "1" + std::string(2000, '}');
+        assert(JSONParser(deepObjects).tryParse().error.code == JSONErrorCode::DepthLimitExceeded);
+        
+        JSONParser limited("[{\"a\": []}]");
+        limited.setMaxDepth(3);
+        assert(limited.tryParse().ok());
+        limited.setMaxDepth(2);
+        assert(limited.tryParse().error.code == JSONErrorCode::DepthLimitExceeded);
+        
+        // Test parse statistics, which are all zero unless the library collects them
+        std::cout << "Testing parse statistics..." << std::endl;
+        JSONParser::resetTotalStats();
+        JSONParser statsParser(R"({"name": "a string long enough to allocate", "n": [1, 2.5, true, null], "o": {}})");
+        statsParser.parse();
+        const JSONParseStats& stats = statsParser.lastStats();
+        if (JSONParser::statsEnabled) {
+            assert(stats.documents == 1 && stats.failedDocuments == 0 && stats.inputBytes == 80);
+            assert(stats.objects == 2 && stats.arrays == 1 && stats.strings == 1 && stats.keys == 3);
+            assert(stats.numbers == 2 && stats.numberBytes == 4 && stats.literals == 2 && stats.literalBytes == 8);
+            assert(stats.stringBytes == 34 && stats.keyBytes == 12 && stats.objectBytes == 80 + 2);
+            assert(stats.arrayBytes == 20 && stats.maxDepth == 2);
+            assert(stats.allocations >= 3 && stats.allocatedBytes > 32);
+            assert(stats.totalCycles >= stats.objectCycles + stats.arrayCycles + stats.stringCycles + stats.numberCycles);
+        } else {
+            assert(stats.documents == 0 && stats.objects == 0 && stats.totalCycles == 0);
+        }
+        
+        std::vector<std::thread> statsThreads;
+        for (int t = 0; t < 4; t++) {
+            statsThreads.emplace_back([&] {
+                JSONParser threadParser;
+                for (int i = 0; i < 100; i++) {
+                    threadParser.reset(views[static_cast<size_t>(i) % views.size()]);
+                    threadParser.tryParse();
+                }
+                threadParser.reset("[1,");
+                threadParser.tryParse();
+            });
+        }
+        for (std::thread& thread : statsThreads) thread.join();
+        JSONParseStats totals = JSONParser::totalStats();
+        if (JSONParser::statsEnabled) {
+            assert(totals.documents == 1 + 4 * 101 && totals.failedDocuments == 4);
+            assert(totals.maxDepth == 3 && totals.objects > 400);
+        } else {
+            assert(totals.documents == 0);
+        }
+        
         std::cout << "✅ All tests passed!\n";
         return 0;
     } catch (const std::exception& e) {
@@ -0,0 +1,115 @@
+#include "json_patch.hpp"
+#include "json_writer.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// Returns true if applying the patch throws
+bool patchFails(const std::string& document, const std::string& patch) {
+    JSONValue value = JSONParser(document).parse();
+    try {
+        JSONPatch::parse(patch).apply(value);
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+int main() {
+    try {
+        // Test every operation, following the RFC 6902 examples
+        std::cout << "Testing operations..." << std::endl;
+        JSONValue document = JSONParser(R"({"foo": ["bar", "baz"], "a/b": {"m~n": 1}, "q": {"r": true}})").parse();
+        JSONPatch::parse(R"([
+            {"op": "add", "path": "/foo/1", "value": "qux"},
+            {"op": "add", "path": "/foo/-", "value": {"deep": [1]}},
+            {"op": "replace", "path": "/a~1b/m~0n", "value": 2},
+            {"op": "remove", "path": "/foo/0"},
+            {"op": "move", "from": "/q/r", "path": "/moved"},
+            {"op": "copy", "from": "/foo/2", "path": "/copied"},
+            {"op": "test", "path": "/copied", "value": {"deep": [1.0]}},
+            {"op": "add", "path": "/q/r", "value": null}
+        ])").apply(document);
+        assert(JSONWriter::toString(document) ==
+               R"({"foo":["qux","baz",{"deep":[1]}],"a/b":{"m~n":2},"q":{"r":null},"moved":true,"copied":{"deep":[1]}})");
+
+        // Test a move relinks the subtree instead of copying it
+        std::cout << "Testing moves..." << std::endl;
+        JSONValue big = JSONParser(R"({"from": {"payload": [1, 2, 3, "a string long enough to allocate"]}, "to": {}})").parse();
+        const void* payload = big["from"]["payload"].asArray().data();
+        std::move(JSONPatch().move("/from/payload", "/to/payload")).apply(big);
+        assert(big["to"]["payload"].asArray().data() == payload);
+        assert(big["from"].asObject().empty());
+
+        // Test failures name the operation
+        std::cout << "Testing errors..." << std::endl;
+        assert(patchFails(R"({"a": 1})", R"([{"op": "test", "path": "/a", "value": 2}])"));
+        assert(patchFails(R"({"a": 1})", R"([{"op": "remove", "path": "/b"}])"));
+        assert(patchFails(R"({"a": [1]})", R"([{"op": "add", "path": "/a/2", "value": 0}])"));
+        assert(patchFails(R"({"a": [1]})", R"([{"op": "add", "path": "/a/01", "value": 0}])"));
+        assert(patchFails(R"({"a": {"b": 1}})", R"([{"op": "move", "from": "/a", "path": "/a/b/c"}])"));
+        assert(patchFails(R"({"a": 1})", R"([{"op": "move", "from": "/missing", "path": "/missing"}])"));
+        assert(patchFails(R"({"a": 1})", R"([{"op": "jump", "path": "/a"}])"));
+        assert(patchFails(R"({"a": 1})", R"([{"op": "add", "path": "/a"}])"));
+        assert(patchFails(R"({"a": 1})", R"([{"op": "add", "path": "a", "value": 0}])"));
+
+        JSONValue kept = JSONParser(R"({"a": {"x": 1}, "b": 2})").parse();
+        try {
+            JSONPatch().move("/a/x", "/b/c").apply(kept);
+            assert(false);
+        } catch (const std::runtime_error&) {
+            assert(kept["a"]["x"].asInt64() == 1);  // A failed move puts the value back
+        }
+        JSONPatch().move("/b", "/b").apply(kept);
+        assert(kept["b"].asInt64() == 2);
+
+        // Test the diff turns one document into the other
+        std::cout << "Testing diff..." << std::endl;
+        const char* pairs[][2] = {
+            {R"({"a": 1, "b": [1, 2, 3], "c": {"d": "x"}})", R"({"a": 1, "b": [1, 3], "c": {"d": "y", "e": null}})"},
+            {R"([1, 2, 3, 4, 5])", R"([0, 1, 2, 3, 4, 5, 6])"},
+            {R"([1, 2, 3, 4, 5])", R"([1, 5])"},
+            {R"({"k/~": [{"x": 1}, {"x": 2}]})", R"({"k/~": [{"x": 1}, {"x": 3}, {"x": 4}]})"},
+            {R"({"a": 1})", R"([1])"},
+            {R"(1)", R"(1.0)"},
+        };
+        for (const auto& pair : pairs) {
+            JSONValue from = JSONParser(pair[0]).parse();
+            JSONValue to = JSONParser(pair[1]).parse();
+            JSONPatch patch = JSONPatch::diff(from, to);
+            JSONPatch::parse(patch.toString()).apply(from);
+            assert(jsonEquals(from, to));
+        }
+        JSONValue config = JSONParser(R"({"servers": [{"host": "a", "port": 80}, {"host": "b", "port": 80}], "debug": false})").parse();
+        JSONValue updated = JSONParser(R"({"servers": [{"host": "a", "port": 80}, {"host": "b", "port": 8080}], "debug": false})").parse();
+        JSONPatch minimal = JSONPatch::diff(config, updated);
+        assert(minimal.size() == 1);
+        assert(minimal.toString() == R"([{"op":"replace","path":"/servers/1/port","value":8080}])");
+        assert(JSONPatch::diff(config, config).empty());
+
+        // Test equality follows RFC 6902
+        assert(jsonEquals(JSONParser(R"({"a": 1, "b": [true]})").parse(), JSONParser(R"({"b": [true], "a": 1.0})").parse()));
+        assert(!jsonEquals(JSONValue(int64_t(-1)), JSONValue(UINT64_MAX)));
+        assert(!jsonEquals(JSONValue("1"), JSONValue(1)));
+
+        // Integers are compared exactly, even against a double they round to
+        JSONValue exact(int64_t(9007199254740993));
+        JSONValue rounded(9007199254740992.0);
+        assert(!jsonEquals(exact, rounded) && !jsonEquals(rounded, exact));
+        assert(jsonEquals(JSONValue(int64_t(9007199254740992)), rounded));
+        assert(!jsonEquals(JSONValue(UINT64_MAX), JSONValue(18446744073709551616.0)));
+        assert(!jsonEquals(JSONValue(int64_t(-3)), JSONValue(-2.5)));
+        assert(jsonEquals(JSONValue(int64_t(-3)), JSONValue(-3.0)));
+        JSONValue withExact = JSONParser(R"({"id": 9007199254740993})").parse();
+        JSONValue withRounded = JSONParser(R"({"id": 9007199254740992.0})").parse();
+        assert(JSONPatch::diff(withRounded, withExact).size() == 1);
+        assert(patchFails(R"({"id": 9007199254740993})", R"([{"op": "test", "path": "/id", "value": 9007199254740992.0}])"));
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,161 @@
+#include "json_query.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// Returns true if compiling the expression throws
+bool pathFails(const std::string& expression) {
+    try {
+        JSONQuery::path(expression);
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+bool pointerFails(const std::string& pointer) {
+    try {
+        JSONQuery::pointer(pointer);
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+// Runs a query on the DOM and on the lazy document and checks both agree on the count
+size_t countBoth(const JSONQuery& query, const JSONValue& dom, const JSONLazyDocument& lazy) {
+    size_t domCount = query.findAll(dom).size();
+    size_t lazyCount = 0;
+    query.forEach(lazy.root(), [&](JSONLazyValue) { lazyCount++; });
+    assert(domCount == lazyCount);
+    return domCount;
+}
+
+int main() {
+    try {
+        std::string json = R"({
+            "events": [
+                {"type": "click", "user": {"id": 1, "name": "ann"}, "score": 3.5},
+                {"type": "view", "user": {"id": 2, "name": "bob"}, "score": 10},
+                {"type": "click", "user": {"id": 3}, "flag": true},
+                {"type": "scroll", "note": null}
+            ],
+            "a/b": {"m~n": "escaped"},
+            "": "empty key",
+            "count": 4
+        })";
+        JSONValue dom = JSONParser(json).parse();
+        JSONLazyDocument lazy(json);
+
+        // Test JSON Pointer
+        std::cout << "Testing JSON Pointer..." << std::endl;
+        JSONQuery firstUser = JSONQuery::pointer("/events/0/user/id");
+        assert(firstUser.isSingular());
+        assert(firstUser.find(dom)->asInt64() == 1);
+        assert(firstUser.find(lazy.root()).asInt64() == 1);
+        assert(JSONQuery::pointer("").find(dom) == &dom);
+        assert(JSONQuery::pointer("/a~1b/m~0n").find(dom)->asString() == "escaped");
+        assert(JSONQuery::pointer("/a~1b/m~0n").find(lazy.root()).asString() == "escaped");
+        assert(JSONQuery::pointer("/").find(dom)->asString() == "empty key");
+        assert(JSONQuery::pointer("/events/4").find(dom) == nullptr);
+        assert(JSONQuery::pointer("/events/-").find(dom) == nullptr);
+        assert(JSONQuery::pointer("/events/01").find(dom) == nullptr);
+        assert(!JSONQuery::pointer("/events/9/user").find(lazy.root()).exists());
+        assert(JSONQuery::pointer("/count/x").find(dom) == nullptr);
+        assert(pointerFails("events"));
+        assert(pointerFails("/bad~2escape"));
+
+        // Test JSONPath child, index and wildcard steps
+        std::cout << "Testing JSONPath..." << std::endl;
+        JSONQuery ids = JSONQuery::path("$.events[*].user.id");
+        assert(!ids.isSingular());
+        assert(countBoth(ids, dom, lazy) == 3);
+        std::vector<const JSONValue*> found = ids.findAll(dom);
+        assert(found[0]->asInt64() == 1 && found[1]->asInt64() == 2 && found[2]->asInt64() == 3);
+        assert(JSONQuery::path("$['events'][-1].type").find(dom)->asString() == "scroll");
+        assert(JSONQuery::path("$[\"a/b\"]['m~n']").find(lazy.root()).asString() == "escaped");
+        assert(JSONQuery::path("$.events[1].score").find(dom)->asInt64() == 10);
+        assert(countBoth(JSONQuery::path("$.events.*.type"), dom, lazy) == 4);
+        assert(countBoth(JSONQuery::path("$.*"), dom, lazy) == 4);
+        assert(countBoth(JSONQuery::path("$"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[7]"), dom, lazy) == 0);
+        assert(countBoth(JSONQuery::path("$.events[3]"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[4]"), dom, lazy) == 0);
+        assert(countBoth(JSONQuery::path("$.events[-4].type"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[-5]"), dom, lazy) == 0);
+        assert(countBoth(JSONQuery::path("$.missing[*]"), dom, lazy) == 0);
+
+        // Test a repeated key resolves as the DOM keeps it: first position, last value
+        std::string repeatedJSON = R"({"a": 1, "b": {"k": 0}, "a": 2, "b": {"k": 3}})";
+        JSONValue repeatedDom = JSONParser(repeatedJSON).parse();
+        JSONLazyDocument repeatedLazy(repeatedJSON);
+        assert(countBoth(JSONQuery::path("$.*"), repeatedDom, repeatedLazy) == 2);
+        assert(countBoth(JSONQuery::path("$[?(@.k == 0)]"), repeatedDom, repeatedLazy) == 0);
+        assert(countBoth(JSONQuery::path("$[?(@.k == 3)]"), repeatedDom, repeatedLazy) == 1);
+        assert(JSONQuery::pointer("/a").find(repeatedDom)->asInt64() == 2);
+        assert(JSONQuery::pointer("/a").find(repeatedLazy.root()).asInt64() == 2);
+        assert(JSONQuery::pointer("/a").extract(repeatedJSON)[0].asInt64() == 2);
+        std::vector<JSONValue> members = JSONQuery::path("$.*").extract(repeatedJSON);
+        assert(members.size() == 2 && members[0].asInt64() == 2 && members[1]["k"].asInt64() == 3);
+
+        // Test filters
+        std::cout << "Testing filters..." << std::endl;
+        assert(countBoth(JSONQuery::path("$.events[?(@.type == 'click')].user.id"), dom, lazy) == 2);
+        assert(countBoth(JSONQuery::path("$.events[?(@.type != \"click\")]"), dom, lazy) == 2);
+        assert(countBoth(JSONQuery::path("$.events[?(@.user.id >= 2)]"), dom, lazy) == 2);
+        assert(countBoth(JSONQuery::path("$.events[?(@.score < 10)]"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[?(@.score <= 10)]"), dom, lazy) == 2);
+        assert(countBoth(JSONQuery::path("$.events[?(@.flag)]"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[?(@.flag == true)]"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[?(@.note == null)]"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[?(@['user'].name > 'ann')]"), dom, lazy) == 1);
+        assert(countBoth(JSONQuery::path("$.events[?(@.type < 3)]"), dom, lazy) == 0);
+
+        // Test integer filters stay exact past 2^53
+        std::string ids64 = R"([{"id": 9007199254740993}, {"id": 9007199254740992}, {"id": 9007199254740992.5e0},
+                                {"id": 18446744073709551615}, {"id": -9223372036854775808}])";
+        JSONValue idDom = JSONParser(ids64).parse();
+        JSONLazyDocument idLazy(ids64);
+        assert(countBoth(JSONQuery::path("$[?(@.id == 9007199254740993)]"), idDom, idLazy) == 1);
+        assert(countBoth(JSONQuery::path("$[?(@.id == 9007199254740992)]"), idDom, idLazy) == 2);
+        assert(countBoth(JSONQuery::path("$[?(@.id > 9007199254740992)]"), idDom, idLazy) == 2);
+        assert(countBoth(JSONQuery::path("$[?(@.id < 0)]"), idDom, idLazy) == 1);
+        assert(countBoth(JSONQuery::path("$[?(@.id >= 18446744073709551615)]"), idDom, idLazy) == 1);
+        assert(JSONQuery::path("$[?(@.id == 9007199254740993)].id").find(idDom)->asInt64() == 9007199254740993);
+
+        JSONLazyValue clicked = JSONQuery::path("$.events[?(@.user.name == 'bob')].type").find(lazy.root());
+        assert(clicked.asString() == "view");
+
+        // Test extraction straight from the raw input
+        std::vector<JSONValue> users = JSONQuery::path("$.events[?(@.type == 'click')].user").extract(json);
+        assert(users.size() == 2);
+        assert(users[0]["name"].asString() == "ann" && users[1]["id"].asInt64() == 3);
+
+        // Test the same plan reused across documents
+        JSONQuery plan = JSONQuery::pointer("/user/id");
+        for (int i = 0; i < 100; i++) {
+            std::string record = "{\"user\": {\"id\": " + std::to_string(i) + "}, \"pad\": [1, 2, 3]}";
+            assert(plan.extract(record)[0].asInt64() == i);
+        }
+
+        // Test malformed expressions
+        assert(pathFails(""));
+        assert(pathFails("events"));
+        assert(pathFails("$..id"));
+        assert(pathFails("$.events["));
+        assert(pathFails("$.events[abc]"));
+        assert(pathFails("$['unterminated]"));
+        assert(pathFails("$[?(@.a === 1)]"));
+        assert(pathFails("$[?(@.a == nope)]"));
+        assert(pathFails("$[?(@.a == [1])]"));
+        assert(pathFails("$[?(@.a == 1]"));
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,172 @@
+#include "json_stream.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Records every event as text so different chunkings can be compared
+class RecordingHandler : public JSONHandler {
+    public:
+        std::string log;
+
+        void onStartObject() override { log += "{"; }
+        void onKey(std::string_view key) override { log += "k:" + std::string(key) + " "; }
+        void onEndObject() override { log += "} "; }
+        void onStartArray() override { log += "["; }
+        void onEndArray() override { log += "] "; }
+        void onString(std::string_view value) override { log += "s:" + std::string(value) + " "; }
+        void onNumber(double value) override { log += "d:" + std::to_string(value) + " "; }
+        void onInt64(int64_t value) override { log += "i:" + std::to_string(value) + " "; }
+        void onUint64(uint64_t value) override { log += "u:" + std::to_string(value) + " "; }
+        void onBool(bool value) override { log += value ? "true " : "false "; }
+        void onNull() override { log += "null "; }
+};
+
+// Counts values without storing them
+class CountingHandler : public JSONHandler {
+    public:
+        size_t values = 0;
+
+        void onInt64(int64_t) override { values++; }
+        void onString(std::string_view) override { values++; }
+};
+
+std::string parseInChunks(const std::string& json, size_t chunkSize) {
+    RecordingHandler handler;
+    JSONStreamParser parser(handler);
+    for (size_t offset = 0; offset < json.size(); offset += chunkSize) {
+        parser.feed(json.data() + offset, std::min(chunkSize, json.size() - offset));
+    }
+    parser.finish();
+    return handler.log;
+}
+
+int main() {
+    try {
+        const std::string document = R"({
+            "name": "Alice",
+            "age": 25,
+            "big": 18446744073709551615,
+            "ratio": -1.5e2,
+            "is_student": false,
+            "grade": null,
+            "escaped": "line\nbreak \"quoted\" \\ slash",
+            "scores": [95, 88, [], {}],
+            "address": { "city": "New York", "zip": 10001 }
+        })";
+
+        // Test events for a whole document
+        std::cout << "Testing whole-document events..." << std::endl;
+        std::string expected = parseInChunks(document, document.size());
+        assert(expected.find("k:name s:Alice ") != std::string::npos);
+        assert(expected.find("k:age i:25 ") != std::string::npos);
+        assert(expected.find("k:big u:18446744073709551615 ") != std::string::npos);
+        assert(expected.find("k:ratio d:-150.000000 ") != std::string::npos);
+        assert(expected.find("k:escaped s:line\nbreak \"quoted\" \\ slash ") != std::string::npos);
+        assert(expected.find("k:scores [i:95 i:88 [] {} ] ") != std::string::npos);
+        assert(expected.find("k:zip i:10001 } } ") != std::string::npos);
+
+        // Test that every chunk size produces the same events
+        std::cout << "Testing chunk boundaries..." << std::endl;
+        for (size_t chunkSize = 1; chunkSize < 40; chunkSize++) {
+            assert(parseInChunks(document, chunkSize) == expected);
+        }
+
+        // Test top-level scalars, which end only at finish()
+        std::cout << "Testing top-level scalars..." << std::endl;
+        assert(parseInChunks("42", 1) == "i:42 ");
+        assert(parseInChunks(" true ", 2) == "true ");
+        assert(parseInChunks("\"x\"", 1) == "s:x ");
+
+        // Test \u escapes and raw UTF-8 split across chunks
+        std::cout << "Testing unicode strings..." << std::endl;
+        for (size_t chunkSize : {size_t(1), size_t(3), size_t(64)}) {
+            assert(parseInChunks("[\"caf\\u00e9 \\ud83d\\ude00\", \"na\xc3\xafve\"]", chunkSize) ==
+                   "[s:caf\xc3\xa9 \xf0\x9f\x98\x80 s:na\xc3\xafve ] ");
+        }
+
+        // Test malformed input, split across chunks as well
+        std::cout << "Testing malformed input..." << std::endl;
+        const char* invalidDocuments[] = {
+            "{\"a\": 1,}", "[1 2]", "[1,]", "{\"a\" 1}", "[tru]", "[1.]", "[\"\\x\"]", "[1] 2", "[1", "{\"a\":", "-",
+            "[\"\\ud800\"]", "[\"\xff\"]", "[\"tab\there\"]"};
+        for (const char* invalid : invalidDocuments) {
+            for (size_t chunkSize : {size_t(1), size_t(64)}) {
+                try {
+                    parseInChunks(invalid, chunkSize);
+                    assert(false);
+                } catch (const std::runtime_error& e) {
+                    if (chunkSize == 1) std::cout << "Caught expected error: " << e.what() << std::endl;
+                }
+            }
+        }
+
+        // Test reading from a std::istream with small chunks
+        std::cout << "Testing istream input..." << std::endl;
+        std::istringstream stream(document);
+        RecordingHandler streamHandler;
+        JSONStreamParser streamParser(streamHandler);
+        streamParser.parse(stream, 7);
+        assert(streamHandler.log == expected);
+
+        // Test reading from a file descriptor
+        std::cout << "Testing file descriptor input..." << std::endl;
+        const char* path = "json_stream_test_input.json";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << document;
+        }
+#ifdef _WIN32
+        int fd = ::_open(path, _O_RDONLY | _O_BINARY);
+#else
+        int fd = ::open(path, O_RDONLY);
+#endif
+        assert(fd >= 0);
+        RecordingHandler fileHandler;
+        JSONStreamParser fileParser(fileHandler);
+        fileParser.parse(fd, 16);
+#ifdef _WIN32
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+        std::remove(path);
+        assert(fileHandler.log == expected);
+
+        // Test that parser memory does not grow with document size
+        std::cout << "Testing constant memory..." << std::endl;
+        CountingHandler counter;
+        JSONStreamParser countingParser(counter);
+        countingParser.feed("[");
+        std::string batch;
+        for (int i = 0; i < 1000; i++) batch += "12345, \"value\", ";
+        for (int round = 0; round < 200; round++) {
+            countingParser.feed(batch);
+            assert(countingParser.depth() == 1);
+        }
+        countingParser.feed("0]");
+        countingParser.finish();
+        assert(counter.values == 400001);
+
+        // Test reuse after reset
+        countingParser.reset();
+        countingParser.feed("[\"again\"]");
+        countingParser.finish();
+        assert(counter.values == 400002);
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
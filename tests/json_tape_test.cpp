@@ -0,0 +1,143 @@
+#include "json_tape.hpp"
+#include "json_writer.hpp"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Returns true if building a tape from json throws
+bool parseFails(const std::string& json) {
+    try {
+        JSONTape tape(json);
+        return false;
+    } catch (const std::exception& e) {
+        std::cout << "Caught expected error: " << e.what() << std::endl;
+        return true;
+    }
+}
+
+int main() {
+    try {
+        // Test accessors on a parsed tape
+        std::cout << "Testing tape accessors..." << std::endl;
+        std::string json = R"({
+            "name": "John Doe",
+            "age": 30,
+            "balance": -12.5,
+            "big": 18446744073709551615,
+            "negative": -7,
+            "isStudent": false,
+            "nothing": null,
+            "address": {"street": "123 Main St", "city": "Anytown"},
+            "scores": [85, 92.5, [1, {"deep": true}], "x"],
+            "esc": "line\nbreak\"quote"
+        })";
+        JSONTape tape(json);
+        JSONTapeValue root = tape.root();
+        assert(root.isObject() && root.size() == 10);
+        assert(root["name"].asString() == "John Doe");
+        assert(root["age"].isInteger() && root["age"].asInt64() == 30);
+        assert(!root["balance"].isInteger() && root["balance"].asNumber() == -12.5);
+        assert(root["big"].asUint64() == UINT64_MAX);
+        assert(root["negative"].asInt64() == -7);
+        assert(root["isStudent"].isBool() && !root["isStudent"].asBool());
+        assert(root["nothing"].isNull() && root["nothing"].exists());
+        assert(root["address"]["city"].asString() == "Anytown");
+        assert(root["scores"].size() == 4);
+        assert(root["scores"][2][1]["deep"].asBool());
+        assert(root["scores"][3].asString() == "x");
+        assert(root["esc"].asString() == "line\nbreak\"quote");
+        assert(!root["missing"].exists() && root["missing"].isNull());
+
+        // Test type errors and bounds
+        bool threw = false;
+        try { root["name"].asNumber(); } catch (const std::exception&) { threw = true; }
+        assert(threw);
+        threw = false;
+        try { root["scores"][4]; } catch (const std::exception&) { threw = true; }
+        assert(threw);
+        threw = false;
+        try { root["negative"].asUint64(); } catch (const std::exception&) { threw = true; }
+        assert(threw);
+
+        // Test iteration order matches the input
+        std::string keys;
+        root.forEachField([&](std::string_view key, JSONTapeValue) { keys += std::string(key) + ","; });
+        assert(keys == "name,age,balance,big,negative,isStudent,nothing,address,scores,esc,");
+
+        // Test round trips through JSONValue
+        std::cout << "Testing JSONValue conversion..." << std::endl;
+        JSONValue dom = JSONParser(json).parse();
+        JSONTape fromDom = JSONTape::fromValue(dom);
+        assert(fromDom.root().size() == 10);
+        assert(fromDom.root()["address"]["street"].asString() == "123 Main St");
+        assert(fromDom.root()["big"].asUint64() == UINT64_MAX);
+        JSONValue back = tape.toValue();
+        assert(JSONWriter::toString(back) == JSONWriter::toString(dom));
+        assert(back["scores"][2][1]["deep"].asBool());
+
+        // Test repeated keys read as the DOM keeps them: first position, last value
+        JSONTape repeated(R"({"a": 1, "b": 0, "a": 2})");
+        assert(repeated.root()["a"].asInt64() == 2 && repeated.root().size() == 2);
+        assert(JSONWriter::toString(repeated.toValue()) == R"({"a":2,"b":0})");
+        keys.clear();
+        repeated.root().forEachField([&](std::string_view key, JSONTapeValue value) {
+            keys += std::string(key) + "=" + std::to_string(value.asInt64()) + ",";
+        });
+        assert(keys == "a=2,b=0,");
+        std::string wide = R"({"a":1,"b":0,"c":0,"d":0,"e":0,"f":0,"g":0,"h":0,"i":0,"a":2,"b":3})";
+        repeated.parse(wide);
+        assert(repeated.root().size() == 9 && repeated.root()["b"].asInt64() == 3);
+        assert(JSONWriter::toString(repeated.toValue()) == JSONWriter::toString(JSONParser(wide).parse()));
+
+        // Test scalar roots, empty containers and reuse
+        tape.parse("  \"just text\"  ");
+        assert(tape.root().asString() == "just text");
+        tape.parse("[[], {}, []]");
+        assert(tape.root().size() == 3 && tape.root()[1].size() == 0 && tape.root()[2].isArray());
+        assert(tape.wordCount() == 8);
+
+        // Test counts at or past the count limit fall back to walking
+        JSONTape limited;
+        limited.setCountLimit(4);
+        limited.parse(R"([1, 2, 3, [4, 5, 6, 7, 8], {"a": 1, "b": 2, "c": 3, "d": 4}, [0, 1, 2]])");
+        assert(limited.root().size() == 6);
+        assert(limited.root()[3].size() == 5 && limited.root()[4].size() == 4 && limited.root()[5].size() == 3);
+        assert(limited.root()[4]["d"].asInt64() == 4);
+        limited.parse(R"({"a": 1, "b": 2, "c": 3, "d": 4, "a": 5})");
+        assert(limited.root().size() == 4 && limited.root()["a"].asInt64() == 5);
+        limited.setCountLimit(SIZE_MAX);
+        assert(limited.empty() && limited.getCountLimit() == JSONTape::maxCountLimit);
+
+        // Test a tape nested deeper than a JSONValue may be refuses to convert
+        std::string deep = std::string(500000, '[') + std::string(500000, ']');
+        tape.parse(deep);
+        threw = false;
+        try { tape.toValue(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        std::string nested = std::string(JSONParser::defaultMaxDepth, '[') + std::string(JSONParser::defaultMaxDepth, ']');
+        tape.parse(nested);
+        assert(JSONWriter::toString(tape.toValue()) == nested);
+
+        // Test stream input
+        std::istringstream in(R"([1, "two", {"three": 3}])");
+        tape.parse(in);
+        assert(tape.root()[2]["three"].asInt64() == 3);
+
+        // Test invalid input leaves an empty tape
+        std::cout << "Testing errors..." << std::endl;
+        assert(parseFails(""));
+        assert(parseFails("[1 2]"));
+        assert(parseFails("{\"a\": }"));
+        assert(parseFails("[truex]"));
+        JSONTape failed;
+        try { failed.parse("[1, 2"); } catch (const std::exception&) {}
+        assert(failed.empty());
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
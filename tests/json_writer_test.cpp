@@ -0,0 +1,90 @@
+#include "json_parser.hpp"
+#include "json_writer.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+
+int main() {
+    try {
+        // Test compact output of scalars and containers
+        std::cout << "Testing compact output..." << std::endl;
+        JSONValue array = JSONParser(R"([1, -2, 2.5, true, false, null, "x", [], {}, {"k": [1, {"n": null}]}])").parse();
+        assert(JSONWriter::toString(array) == R"([1,-2,2.5,true,false,null,"x",[],{},{"k":[1,{"n":null}]}])");
+
+        // Test indented output
+        std::cout << "Testing indented output..." << std::endl;
+        JSONValue nested = JSONParser(R"({"list": [1, {"a": "b"}], "empty": []})").parse();
+        JSONValue listOnly = JSONParser(R"({"list": [1, {"a": "b"}]})").parse();
+        assert(JSONWriter::toString(listOnly, 2) ==
+               "{\n"
+               "  \"list\": [\n"
+               "    1,\n"
+               "    {\n"
+               "      \"a\": \"b\"\n"
+               "    }\n"
+               "  ]\n"
+               "}");
+
+        // Test escaping, including runs longer than one SIMD block
+        std::cout << "Testing string escaping..." << std::endl;
+        std::string raw = "plain text that is longer than sixteen bytes \"quoted\" back\\slash\n\t\x01 end";
+        JSONValue text(raw);
+        std::string escaped = JSONWriter::toString(text);
+        assert(escaped == "\"plain text that is longer than sixteen bytes \\\"quoted\\\" back\\\\slash\\n\\t\\u0001 end\"");
+        assert(JSONWriter::toString(JSONValue("caf\xc3\xa9")) == "\"caf\xc3\xa9\"");
+
+        // Test number formatting round-trips exactly
+        std::cout << "Testing number formatting..." << std::endl;
+        JSONValue numbers = JSONParser("[0.1, 1e300, -5e-324, 9007199254740993, 18446744073709551615]").parse();
+        std::string numberText = JSONWriter::toString(numbers);
+        assert(numberText == "[0.1,1e+300,-5e-324,9007199254740993,18446744073709551615]");
+        JSONValue reparsed = JSONParser(numberText).parse();
+        assert(reparsed[0].asNumber() == 0.1);
+        assert(reparsed[2].asNumber() == -5e-324);
+        assert(reparsed[4].asUint64() == UINT64_MAX);
+
+        // Test round trip of a whole document through the reusable buffer
+        std::cout << "Testing round trip..." << std::endl;
+        JSONWriter writer;
+        for (int round = 0; round < 2; round++) {
+            const std::string& text = writer.write(nested);
+            JSONValue back = JSONParser(text).parse();
+            assert(back["list"][1]["a"].asString() == "b");
+            assert(back["empty"].asArray().empty());
+        }
+
+        // Test writing to a stream
+        std::cout << "Testing stream output..." << std::endl;
+        JSONValue big;
+        for (int i = 0; i < 20000; i++) {
+            big[static_cast<size_t>(i)] = "element number " + std::to_string(i);
+        }
+        std::ostringstream stream;
+        JSONWriter(1).write(big, stream);
+        JSONValue streamed = JSONParser(stream.str()).parse();
+        assert(streamed.asArray().size() == 20000);
+        assert(streamed[19999].asString() == "element number 19999");
+
+        // Test the streaming interface
+        std::cout << "Testing streaming interface..." << std::endl;
+        JSONWriter events;
+        events.beginObject().writeKey("id").writeInt64(-7).writeKey("tags").beginArray()
+              .writeString("a").writeBool(true).endArray().endObject();
+        assert(events.str() == R"({"id":-7,"tags":["a",true]})");
+
+        try {
+            JSONWriter misuse;
+            misuse.beginObject().writeString("no key");
+            assert(false);
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught expected error: " << e.what() << std::endl;
+        }
+
+        std::cout << "✅ All tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}